@@ -0,0 +1,102 @@
+﻿// Baselines.cs
+
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+using R3ALInterop;
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+
+namespace GoldenTests
+{
+
+    /// <summary>
+    /// Reads and writes Reference\Baselines.txt, the checked-in time and
+    /// memory baselines. One line per case: name, milliseconds and peak bytes,
+    /// separated by tabs. Lines starting with # are comments. A case without
+    /// a line has no baselines and only its outputs are checked.
+    /// </summary>
+    public static class Baselines
+    {
+        /// <summary>
+        /// Sets the baselines of every case listed in the file, if it exists.
+        /// </summary>
+        /// <returns>The names of the cases left without baselines</returns>
+        public static List<string> Load(string file, List<MGoldenCase> cases)
+        {
+            Dictionary<string, string[]> lines = new Dictionary<string, string[]>(StringComparer.OrdinalIgnoreCase);
+
+            if (File.Exists(file))
+            {
+                foreach (string line in File.ReadAllLines(file))
+                {
+                    if (line.Length == 0 || line.StartsWith("#"))
+                        continue;
+
+                    string[] fields = line.Split('\t');
+
+                    if (fields.Length != 3)
+                        throw new FormatException(string.Format("Malformed baseline line in \"{0}\": {1}", file, line));
+
+                    lines[fields[0]] = fields;
+                }
+            }
+
+            List<string> missing = new List<string>();
+
+            foreach (MGoldenCase golden in cases)
+            {
+                string[] fields;
+
+                if (!lines.TryGetValue(golden.Name, out fields))
+                {
+                    missing.Add(golden.Name);
+                    continue;
+                }
+
+                golden.BaselineMilliseconds = double.Parse(fields[1], CultureInfo.InvariantCulture);
+                golden.BaselinePeakBytes = long.Parse(fields[2], CultureInfo.InvariantCulture);
+            }
+
+            return missing;
+        }
+
+        /// <summary>
+        /// Replaces the file with the measurements of freshly recorded cases.
+        /// Cases that failed to record are left out.
+        /// </summary>
+        public static void Save(string file, List<MGoldenResult> results)
+        {
+            List<string> lines = new List<string>
+            {
+                "# Time and memory baselines of the reference cases, written by \"GoldenTests record\".",
+                "# Recorded on " + Environment.MachineName + ", " + DateTime.UtcNow.ToString("yyyy-MM-dd", CultureInfo.InvariantCulture) +
+                    ". Re-record when the reference machine changes.",
+                "# case\tmilliseconds\tpeak bytes"
+            };
+
+            foreach (MGoldenResult result in results)
+            {
+                if (result.Passed)
+                    lines.Add(string.Format(CultureInfo.InvariantCulture, "{0}\t{1:0.0}\t{2}", result.Name, result.Milliseconds, result.PeakBytes));
+            }
+
+            File.WriteAllLines(file, lines);
+        }
+    }
+
+}
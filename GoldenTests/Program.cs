@@ -0,0 +1,144 @@
+﻿// Program.cs
+
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+using R3ALInterop;
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace GoldenTests
+{
+
+    /// <summary>
+    /// Builds the reference projects and compares every output byte for byte
+    /// with the checked-in goldens.
+    ///
+    ///     GoldenTests [verify | deterministic | record] [reference directory]
+    ///
+    /// verify (the default) compares with the goldens and with the time and
+    /// memory baselines in Reference\Baselines.txt, then runs the
+    /// deterministic check too. deterministic builds each case twice and
+    /// compares the builds, which tests IOvlProject.IsDeterministic (the
+    /// output cache relies on it) and needs no goldens. record replaces the
+    /// goldens and the baselines with fresh builds. Returns 0 if every case
+    /// passed, 1 otherwise.
+    ///
+    /// The goldens and baselines have to be recorded on Windows, with the
+    /// game's asset library: until then verify reports every generated OVL
+    /// as missing. Baselines depend on the machine, record them on the one
+    /// that runs verify.
+    /// </summary>
+    public static class Program
+    {
+        public static int Main(string[] args)
+        {
+            string mode = args.Length > 0 ? args[0].ToLowerInvariant() : "verify";
+            string root = args.Length > 1 ? args[1] : FindReferenceDirectory();
+
+            if (root == null || !Directory.Exists(Path.Combine(root, "Inputs")))
+            {
+                Console.Error.WriteLine("Reference directory not found, pass it as the second argument.");
+                return 2;
+            }
+
+            RCT3AssetLibrary.Initialize(null);
+
+            List<MGoldenCase> cases = ReferenceCases.Create(root);
+            List<MGoldenResult> results = new List<MGoldenResult>();
+            string baselines = Path.Combine(root, "Baselines.txt");
+
+            try
+            {
+                switch (mode)
+                {
+                    case "verify":
+                        foreach (string name in Baselines.Load(baselines, cases))
+                            Console.WriteLine("{0}: no baselines recorded, time and memory not checked", name);
+
+                        results = MGoldenVerifier.VerifyAll(cases, new MGoldenThresholds());
+                        results.AddRange(VerifyDeterministic(cases));
+                        break;
+
+                    case "deterministic":
+                        results = VerifyDeterministic(cases);
+                        break;
+
+                    case "record":
+                        foreach (MGoldenCase golden in cases)
+                            results.Add(MGoldenVerifier.Record(golden));
+
+                        Baselines.Save(baselines, results);
+                        break;
+
+                    default:
+                        Console.Error.WriteLine("Unknown mode \"{0}\", expected verify, deterministic or record.", mode);
+                        return 2;
+                }
+            }
+            catch (Exception e)
+            {
+                Console.Error.WriteLine(e.Message);
+                return 1;
+            }
+
+            Console.Write(MGoldenVerifier.Report(results));
+
+            return results.TrueForAll(result => result.Passed) ? 0 : 1;
+        }
+
+        /// <summary>
+        /// Builds every case twice, each result is named after its case with
+        /// " (deterministic)" added.
+        /// </summary>
+        private static List<MGoldenResult> VerifyDeterministic(List<MGoldenCase> cases)
+        {
+            List<MGoldenResult> results = new List<MGoldenResult>();
+
+            foreach (MGoldenCase golden in cases)
+            {
+                MGoldenResult result = MGoldenVerifier.VerifyDeterministic(golden);
+                result.Name += " (deterministic)";
+                results.Add(result);
+            }
+
+            return results;
+        }
+
+        /// <summary>
+        /// Looks for GoldenTests\Reference above the executable, so the source
+        /// tree is used whether the program runs from bin\Debug or bin\Release.
+        /// </summary>
+        private static string FindReferenceDirectory()
+        {
+            for (DirectoryInfo directory = new DirectoryInfo(AppDomain.CurrentDomain.BaseDirectory); directory != null; directory = directory.Parent)
+            {
+                string reference = Path.Combine(directory.FullName, "Reference");
+
+                if (Directory.Exists(reference))
+                    return reference;
+
+                reference = Path.Combine(directory.FullName, "GoldenTests", "Reference");
+
+                if (Directory.Exists(reference))
+                    return reference;
+            }
+
+            return null;
+        }
+    }
+
+}
@@ -0,0 +1,111 @@
+﻿// ReferenceCases.cs
+
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+using R3ALInterop;
+using System.Collections.Generic;
+using System.IO;
+
+namespace GoldenTests
+{
+
+    /// <summary>
+    /// The synthetic reference projects. Their inputs live in Reference\Inputs:
+    /// generated TGA textures and placeholder model OVLs, which are only copied,
+    /// never parsed. The expected outputs of each case live in
+    /// Reference\Goldens\(case name).
+    /// </summary>
+    public static class ReferenceCases
+    {
+        /// <summary>
+        /// Returns every case, reading inputs and goldens from the given directory.
+        /// </summary>
+        /// <param name="root">The Reference directory</param>
+        public static List<MGoldenCase> Create(string root)
+        {
+            string inputs = Path.Combine(root, "Inputs");
+            string goldens = Path.Combine(root, "Goldens");
+
+            return new List<MGoldenCase>
+            {
+                CreateCase("Basic", CreatePath(inputs, false), goldens),
+                CreateCase("Extended", CreatePath(inputs, true), goldens),
+                CreateCase("Queue", CreateQueue(inputs), goldens)
+            };
+        }
+
+        private static MGoldenCase CreateCase(string name, IOvlProject project, string goldens)
+        {
+            MGoldenCase golden = new MGoldenCase();
+            golden.Name = name;
+            golden.Project = project;
+            golden.Outputs = MOvlOutputs.All;
+            golden.GoldenDirectory = Path.Combine(goldens, name);
+
+            // Time and memory baselines come from Baselines.Load
+            return golden;
+        }
+
+        /// <summary>
+        /// A path with every basic section, and every extended section plus
+        /// paving if extended.
+        /// </summary>
+        private static MPath CreatePath(string inputs, bool extended)
+        {
+            MPath path = new MPath();
+            path.Name = extended ? "GoldenExtended" : "GoldenBasic";
+            path.IngameName = extended ? "Golden Extended Path" : "Golden Basic Path";
+            path.Icon = Path.Combine(inputs, "Icon.tga");
+            path.TextureA = Path.Combine(inputs, "GroundA.tga");
+            path.TextureB = Path.Combine(inputs, "GroundB.tga");
+            path.IsExtended = extended;
+
+            foreach (MSectionInfo section in MSectionSchema.PathSections)
+            {
+                if (section.Set == MSectionSet.Basic || extended)
+                    path.SetSection(section.Index, new MPathSection(Model(inputs, "GoldenPath", section.Name)));
+            }
+
+            if (extended)
+                path.Paving = new MPathSection(Model(inputs, "GoldenPath", "Paving"));
+
+            return path;
+        }
+
+        /// <summary>
+        /// A queue with every section, including the optional SlopeStraight2.
+        /// </summary>
+        private static MQueue CreateQueue(string inputs)
+        {
+            MQueue queue = new MQueue();
+            queue.Name = "GoldenQueue";
+            queue.IngameName = "Golden Queue";
+            queue.Icon = Path.Combine(inputs, "Icon.tga");
+            queue.Texture = Path.Combine(inputs, "QueueRail.tga");
+
+            foreach (MSectionInfo section in MSectionSchema.QueueSections)
+                queue.SetSection(section.Index, Model(inputs, "GoldenQueue", section.Name));
+
+            return queue;
+        }
+
+        private static string Model(string inputs, string prefix, string section)
+        {
+            return Path.Combine(inputs, "Models", prefix + section + ".common.ovl");
+        }
+    }
+
+}
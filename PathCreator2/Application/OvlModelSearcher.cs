@@ -199,19 +199,11 @@ namespace PathCreator
                 else
                     _remainingOvlModels.Clear();
 
-                _remainingOvlModels.Add("Straight");
-                _remainingOvlModels.Add("TurnL");
-                _remainingOvlModels.Add("TurnR");
-                _remainingOvlModels.Add("SlopeUp");
-                _remainingOvlModels.Add("SlopeDown");
-                _remainingOvlModels.Add("SlopeStraight");
-
-                _ovlModels.Add("Straight", ovl => { _queue.Straight = ovl; _found++; _remainingOvlModels.Remove("Straight"); });
-                _ovlModels.Add("TurnL", ovl => { _queue.TurnL = ovl; _found++; _remainingOvlModels.Remove("TurnL"); });
-                _ovlModels.Add("TurnR", ovl => { _queue.TurnR = ovl; _found++; _remainingOvlModels.Remove("TurnR"); });
-                _ovlModels.Add("SlopeUp", ovl => { _queue.SlopeUp = ovl; _found++; _remainingOvlModels.Remove("SlopeUp"); });
-                _ovlModels.Add("SlopeDown", ovl => { _queue.SlopeDown = ovl; _found++; _remainingOvlModels.Remove("SlopeDown"); });
-                _ovlModels.Add("SlopeStraight", ovl => { _queue.SlopeStraight1 = ovl; _found++; _remainingOvlModels.Remove("SlopeStraight"); });
+                foreach (MSectionInfo section in MSectionSchema.QueueSections)
+                {
+                    if (section.Role != null)
+                        addQueueModel(section);
+                }
             }
             else
             {
@@ -241,90 +233,36 @@ namespace PathCreator
                         _remainingOvlModels.Clear();
                 }
 
-                _remainingOvlModels.Add("Flat");
-                _remainingOvlModels.Add("StraightA");
-                _remainingOvlModels.Add("StraightB");
-                _remainingOvlModels.Add("CornerA");
-                _remainingOvlModels.Add("CornerB");
-                _remainingOvlModels.Add("CornerC");
-                _remainingOvlModels.Add("CornerD");
-                _remainingOvlModels.Add("TurnU");
-                _remainingOvlModels.Add("TurnLA");
-                _remainingOvlModels.Add("TurnLB");
-                _remainingOvlModels.Add("TurnTA");
-                _remainingOvlModels.Add("TurnTB");
-                _remainingOvlModels.Add("TurnTC");
-                _remainingOvlModels.Add("TurnX");
-                _remainingOvlModels.Add("Slope");
-                _remainingOvlModels.Add("SlopeStraight");
-                _remainingOvlModels.Add("SlopeStraightLeft");
-                _remainingOvlModels.Add("SlopeStraightRight");
-                _remainingOvlModels.Add("SlopeMid");
-
-                _ovlModels.Add("Flat", ovl => { _path.Flat = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("Flat"); });
-                _ovlModels.Add("StraightA", ovl => { _path.StraightA = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("StraightA"); });
-                _ovlModels.Add("StraightB", ovl => { _path.StraightB = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("StraightB"); });
-                _ovlModels.Add("CornerA", ovl => { _path.CornerA = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("CornerA"); });
-                _ovlModels.Add("CornerB", ovl => { _path.CornerB = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("CornerB"); });
-                _ovlModels.Add("CornerC", ovl => { _path.CornerC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("CornerC"); });
-                _ovlModels.Add("CornerD", ovl => { _path.CornerD = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("CornerD"); });
-                _ovlModels.Add("TurnU", ovl => { _path.TurnU = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnU"); });
-                _ovlModels.Add("TurnLA", ovl => { _path.TurnLA = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnLA"); });
-                _ovlModels.Add("TurnLB", ovl => { _path.TurnLB = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnLB"); });
-                _ovlModels.Add("TurnTA", ovl => { _path.TurnTA = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnTA"); });
-                _ovlModels.Add("TurnTB", ovl => { _path.TurnTB = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnTB"); });
-                _ovlModels.Add("TurnTC", ovl => { _path.TurnTC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnTC"); });
-                _ovlModels.Add("TurnX", ovl => { _path.TurnX = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("TurnX"); });
-                _ovlModels.Add("Slope", ovl => { _path.Slope = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("Slope"); });
-                _ovlModels.Add("SlopeStraight", ovl => { _path.SlopeStraight = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraight"); });
-                _ovlModels.Add("SlopeStraightLeft", ovl => { _path.SlopeStraightL = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightLeft"); });
-                _ovlModels.Add("SlopeStraightRight", ovl => { _path.SlopeStraightR = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightRight"); });
-                _ovlModels.Add("SlopeMid", ovl => { _path.SlopeMid = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeMid"); });
-
-                if (_path.IsExtended)
+                foreach (MSectionInfo section in MSectionSchema.PathSections)
                 {
-                    _remainingOvlModels.Add("FlatFC");
-                    _remainingOvlModels.Add("SlopeFC");
-                    _remainingOvlModels.Add("SlopeBC");
-                    _remainingOvlModels.Add("SlopeTC");
-                    _remainingOvlModels.Add("SlopeStraightFC");
-                    _remainingOvlModels.Add("SlopeStraightBC");
-                    _remainingOvlModels.Add("SlopeStraightTC");
-                    _remainingOvlModels.Add("SlopeStraightLeftFC");
-                    _remainingOvlModels.Add("SlopeStraightLeftBC");
-                    _remainingOvlModels.Add("SlopeStraightLeftTC");
-                    _remainingOvlModels.Add("SlopeStraightRightFC");
-                    _remainingOvlModels.Add("SlopeStraightRightBC");
-                    _remainingOvlModels.Add("SlopeStraightRightTC");
-                    _remainingOvlModels.Add("SlopeMidFC");
-                    _remainingOvlModels.Add("SlopeMidBC");
-                    _remainingOvlModels.Add("SlopeMidTC");
-                    _remainingOvlModels.Add("Paving");
-
-                    _ovlModels.Add("FlatFC", ovl => { _path.FlatFC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("FlatFC"); });
-                    _ovlModels.Add("SlopeFC", ovl => { _path.SlopeFC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeFC"); });
-                    _ovlModels.Add("SlopeBC", ovl => { _path.SlopeBC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeBC"); });
-                    _ovlModels.Add("SlopeTC", ovl => { _path.SlopeTC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeTC"); });
-                    _ovlModels.Add("SlopeStraightFC", ovl => { _path.SlopeStraightFC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightFC"); });
-                    _ovlModels.Add("SlopeStraightBC", ovl => { _path.SlopeStraightBC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightBC"); });
-                    _ovlModels.Add("SlopeStraightTC", ovl => { _path.SlopeStraightTC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightTC"); });
-                    _ovlModels.Add("SlopeStraightLeftFC", ovl => { _path.SlopeStraightLFC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightLeftFC"); });
-                    _ovlModels.Add("SlopeStraightLeftBC", ovl => { _path.SlopeStraightLBC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightLeftBC"); });
-                    _ovlModels.Add("SlopeStraightLeftTC", ovl => { _path.SlopeStraightLTC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightLeftTC"); });
-                    _ovlModels.Add("SlopeStraightRightFC", ovl => { _path.SlopeStraightRFC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightRightFC"); });
-                    _ovlModels.Add("SlopeStraightRightBC", ovl => { _path.SlopeStraightRBC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightRightBC"); });
-                    _ovlModels.Add("SlopeStraightRightTC", ovl => { _path.SlopeStraightRTC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeStraightRightTC"); });
-                    _ovlModels.Add("SlopeMidFC", ovl => { _path.SlopeMidFC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeMidFC"); });
-                    _ovlModels.Add("SlopeMidBC", ovl => { _path.SlopeMidBC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeMidBC"); });
-                    _ovlModels.Add("SlopeMidTC", ovl => { _path.SlopeMidTC = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("SlopeMidTC"); });
-                    _ovlModels.Add("Paving", ovl => { _path.Paving = new MPathSection(ovl); _found++; _remainingOvlModels.Remove("Paving"); });
-
+                    if (section.Set == MSectionSet.Basic || _path.IsExtended)
+                        addPathModel(section);
                 }
             }
 
             _found = 0;
         }
 
+        /// <summary>
+        /// Registers a queue section so the search fills it in.
+        /// </summary>
+        /// <param name="section">The section, which must have a role.</param>
+        private void addQueueModel(MSectionInfo section)
+        {
+            _remainingOvlModels.Add(section.Role);
+            _ovlModels.Add(section.Role, ovl => { _queue.SetSection(section.Index, ovl); _found++; _remainingOvlModels.Remove(section.Role); });
+        }
+
+        /// <summary>
+        /// Registers a path section so the search fills it in.
+        /// </summary>
+        /// <param name="section">The section.</param>
+        private void addPathModel(MSectionInfo section)
+        {
+            _remainingOvlModels.Add(section.Role);
+            _ovlModels.Add(section.Role, ovl => { _path.SetSection(section.Index, new MPathSection(ovl)); _found++; _remainingOvlModels.Remove(section.Role); });
+        }
+
         /// <summary>
         /// Searches a directory to find OVL model files which follow the Regex pattern.
         /// </summary>
@@ -213,223 +213,22 @@ namespace PathCreator
                 errorList += $"Error { errorCount }: TextureB not specified or file doesn't exist.";
             }
 
-            if (!File.Exists(PathObject.Flat.Section))
+            foreach (MSectionInfo section in MSectionSchema.PathSections)
             {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'Flat' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.StraightA.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'StraightA' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.StraightB.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'StraightB' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.CornerA.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'CornerA' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.CornerB.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'CornerB' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.CornerC.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'CornerC' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.CornerD.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'CornerD' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnU.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnU' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnLA.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnLA' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnLB.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnLB' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnTA.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnTA' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnTB.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnTB' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnTC.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnTC' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.TurnX.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'TurnX' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.Slope.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'Slope' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.SlopeStraight.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'SlopeStraight' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.SlopeStraightL.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'SlopeStraightL' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.SlopeStraightR.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'SlopeStraightR' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (!File.Exists(PathObject.SlopeMid.Section))
-            {
-                errorCount++;
-                errorList += $"Error { errorCount }: 'SlopeMid' model OVL not specified or OVL doesn't exist.";
-            }
-
-            if (PathObject.IsExtended)
-            {
-
-                if (!string.IsNullOrWhiteSpace(PathObject.FlatFC.Section) && !File.Exists(PathObject.FlatFC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'FlatFC' model OVL doesn't exist.\n";
-                }
+                string model = PathObject.GetSection(section.Index).Section;
 
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeFC.Section) && !File.Exists(PathObject.SlopeFC.Section))
+                if (section.Required)
                 {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeFC' model OVL doesn't exist.\n";
+                    if (!File.Exists(model))
+                    {
+                        errorCount++;
+                        errorList += $"Error { errorCount }: '{ section.Name }' model OVL not specified or OVL doesn't exist.";
+                    }
                 }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeBC.Section) && !File.Exists(PathObject.SlopeBC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeBC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeTC.Section) && !File.Exists(PathObject.SlopeTC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeTC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightFC.Section) && !File.Exists(PathObject.SlopeStraightFC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightFC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightBC.Section) && !File.Exists(PathObject.SlopeStraightBC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightBC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightTC.Section) && !File.Exists(PathObject.SlopeStraightTC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightTC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightLFC.Section) && !File.Exists(PathObject.SlopeStraightLFC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightLFC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightLBC.Section) && !File.Exists(PathObject.SlopeStraightLBC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightLBC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightLTC.Section) && !File.Exists(PathObject.SlopeStraightLTC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightLTC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightRFC.Section) && !File.Exists(PathObject.SlopeStraightRFC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightRFC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightRBC.Section) && !File.Exists(PathObject.SlopeStraightRBC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightRBC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeStraightRTC.Section) && !File.Exists(PathObject.SlopeStraightRTC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeStraightRTC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeMidFC.Section) && !File.Exists(PathObject.SlopeMidFC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeMidFC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeMidBC.Section) && !File.Exists(PathObject.SlopeMidBC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeMidBC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.SlopeMidTC.Section) && !File.Exists(PathObject.SlopeMidTC.Section))
-                {
-                    errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'SlopeMidTC' model OVL doesn't exist.\n";
-                }
-
-                if (!string.IsNullOrWhiteSpace(PathObject.Paving.Section) && !File.Exists(PathObject.Paving.Section))
+                else if (PathObject.IsExtended && !string.IsNullOrWhiteSpace(model) && !File.Exists(model))
                 {
                     errorCount++;
-                    errorList += $"Error { errorCount }: Optional 'Paving' model OVL doesn't exist.\n";
+                    errorList += $"Error { errorCount }: Optional '{ section.Name }' model OVL doesn't exist.\n";
                 }
             }
 
@@ -86,13 +86,8 @@ namespace PathCreator
                         w.Write(queue.Icon);
                         w.Write(queue.Texture);
                         w.Write(queue.Shared);
-                        w.Write(queue.Straight);
-                        w.Write(queue.TurnL);
-                        w.Write(queue.TurnR);
-                        w.Write(queue.SlopeUp);
-                        w.Write(queue.SlopeDown);
-                        w.Write(queue.SlopeStraight1);
-                        w.Write(queue.SlopeStraight2);
+                        foreach (MSectionInfo section in MSectionSchema.QueueSections)
+                            w.Write(queue.GetSection(section.Index));
                         w.Write(queue.Recolor1);
                         w.Write(queue.Recolor2);
                         w.Write(queue.Recolor3);
@@ -106,25 +101,7 @@ namespace PathCreator
                         w.Write(path.TextureA);
                         w.Write(path.TextureB);
                         w.Write(path.Shared);
-                        w.Write(path.Flat.Section);
-                        w.Write(path.StraightA.Section);
-                        w.Write(path.StraightB.Section);
-                        w.Write(path.CornerA.Section);
-                        w.Write(path.CornerB.Section);
-                        w.Write(path.CornerC.Section);
-                        w.Write(path.CornerD.Section);
-                        w.Write(path.TurnU.Section);
-                        w.Write(path.TurnLA.Section);
-                        w.Write(path.TurnLB.Section);
-                        w.Write(path.TurnTA.Section);
-                        w.Write(path.TurnTB.Section);
-                        w.Write(path.TurnTC.Section);
-                        w.Write(path.TurnX.Section);
-                        w.Write(path.Slope.Section);
-                        w.Write(path.SlopeStraight.Section);
-                        w.Write(path.SlopeStraightL.Section);
-                        w.Write(path.SlopeStraightR.Section);
-                        w.Write(path.SlopeMid.Section);
+                        WriteSections(w, path, MSectionSet.Basic);
                         w.Write(path.UnderwaterSupport);
                         w.Write(path.IsExtended);
 
@@ -132,23 +109,7 @@ namespace PathCreator
                         {
                             w.Write(path.Unknown01);
                             w.Write(path.Unknown02);
-                            w.Write(path.FlatFC.Section);
-                            w.Write(path.SlopeFC.Section);
-                            w.Write(path.SlopeBC.Section);
-                            w.Write(path.SlopeTC.Section);
-                            w.Write(path.SlopeStraightFC.Section);
-                            w.Write(path.SlopeStraightBC.Section);
-                            w.Write(path.SlopeStraightTC.Section);
-                            w.Write(path.SlopeStraightLFC.Section);
-                            w.Write(path.SlopeStraightLBC.Section);
-                            w.Write(path.SlopeStraightLTC.Section);
-                            w.Write(path.SlopeStraightRFC.Section);
-                            w.Write(path.SlopeStraightRBC.Section);
-                            w.Write(path.SlopeStraightRTC.Section);
-                            w.Write(path.SlopeMidFC.Section);
-                            w.Write(path.SlopeMidBC.Section);
-                            w.Write(path.SlopeMidTC.Section);
-                            w.Write(path.Paving.Section);
+                            WriteSections(w, path, MSectionSet.Extended);
                         }
                     }
                 }
@@ -260,13 +221,8 @@ namespace PathCreator
                         queue.Icon = r.ReadString();
                         queue.Texture = r.ReadString();
                         queue.Shared = r.ReadString();
-                        queue.Straight = r.ReadString();
-                        queue.TurnL = r.ReadString();
-                        queue.TurnR = r.ReadString();
-                        queue.SlopeUp = r.ReadString();
-                        queue.SlopeDown = r.ReadString();
-                        queue.SlopeStraight1 = r.ReadString();
-                        queue.SlopeStraight2 = r.ReadString();
+                        foreach (MSectionInfo section in MSectionSchema.QueueSections)
+                            queue.SetSection(section.Index, r.ReadString());
                         queue.Recolor1 = r.ReadBoolean();
                         queue.Recolor2 = r.ReadBoolean();
                         queue.Recolor3 = r.ReadBoolean();
@@ -282,25 +238,7 @@ namespace PathCreator
                         path.TextureA = r.ReadString();
                         path.TextureB = r.ReadString();
                         path.Shared = r.ReadString();
-                        path.Flat = new MPathSection(r.ReadString());
-                        path.StraightA = new MPathSection(r.ReadString());
-                        path.StraightB = new MPathSection(r.ReadString());
-                        path.CornerA = new MPathSection(r.ReadString());
-                        path.CornerB = new MPathSection(r.ReadString());
-                        path.CornerC = new MPathSection(r.ReadString());
-                        path.CornerD = new MPathSection(r.ReadString());
-                        path.TurnU = new MPathSection(r.ReadString());
-                        path.TurnLA = new MPathSection(r.ReadString());
-                        path.TurnLB = new MPathSection(r.ReadString());
-                        path.TurnTA = new MPathSection(r.ReadString());
-                        path.TurnTB = new MPathSection(r.ReadString());
-                        path.TurnTC = new MPathSection(r.ReadString());
-                        path.TurnX = new MPathSection(r.ReadString());
-                        path.Slope = new MPathSection(r.ReadString());
-                        path.SlopeStraight = new MPathSection(r.ReadString());
-                        path.SlopeStraightL = new MPathSection(r.ReadString());
-                        path.SlopeStraightR = new MPathSection(r.ReadString());
-                        path.SlopeMid = new MPathSection(r.ReadString());
+                        ReadSections(r, path, MSectionSet.Basic);
                         path.UnderwaterSupport = r.ReadBoolean();
                         path.IsExtended = r.ReadBoolean();
 
@@ -308,23 +246,7 @@ namespace PathCreator
                         {
                             path.Unknown01 = r.ReadUInt32();
                             path.Unknown02 = r.ReadUInt32();
-                            path.FlatFC = new MPathSection(r.ReadString());
-                            path.SlopeFC = new MPathSection(r.ReadString());
-                            path.SlopeBC = new MPathSection(r.ReadString());
-                            path.SlopeTC = new MPathSection(r.ReadString());
-                            path.SlopeStraightFC = new MPathSection(r.ReadString());
-                            path.SlopeStraightBC = new MPathSection(r.ReadString());
-                            path.SlopeStraightTC = new MPathSection(r.ReadString());
-                            path.SlopeStraightLFC = new MPathSection(r.ReadString());
-                            path.SlopeStraightLBC = new MPathSection(r.ReadString());
-                            path.SlopeStraightLTC = new MPathSection(r.ReadString());
-                            path.SlopeStraightRFC = new MPathSection(r.ReadString());
-                            path.SlopeStraightRBC = new MPathSection(r.ReadString());
-                            path.SlopeStraightRTC = new MPathSection(r.ReadString());
-                            path.SlopeMidFC = new MPathSection(r.ReadString());
-                            path.SlopeMidBC = new MPathSection(r.ReadString());
-                            path.SlopeMidTC = new MPathSection(r.ReadString());
-                            path.Paving = new MPathSection(r.ReadString());
+                            ReadSections(r, path, MSectionSet.Extended);
                         }
                     }
                 }
@@ -363,6 +285,36 @@ namespace PathCreator
             return false;
         }
 
+        /// <summary>
+        /// Writes the model OVL of every path section in the given set, in schema order.
+        /// </summary>
+        /// <param name="w">The stream to the file</param>
+        /// <param name="path">The path to save</param>
+        /// <param name="set">The sections to write</param>
+        private static void WriteSections(BinaryWriter w, MPath path, MSectionSet set)
+        {
+            foreach (MSectionInfo section in MSectionSchema.PathSections)
+            {
+                if (section.Set == set)
+                    w.Write(path.GetSection(section.Index).Section);
+            }
+        }
+
+        /// <summary>
+        /// Reads the model OVL of every path section in the given set, in schema order.
+        /// </summary>
+        /// <param name="r">The stream to the file</param>
+        /// <param name="path">The path to load into</param>
+        /// <param name="set">The sections to read</param>
+        private static void ReadSections(BinaryReader r, MPath path, MSectionSet set)
+        {
+            foreach (MSectionInfo section in MSectionSchema.PathSections)
+            {
+                if (section.Set == set)
+                    path.SetSection(section.Index, new MPathSection(r.ReadString()));
+            }
+        }
+
         /// <summary>
         /// Upgrades the CPATH file format from Path Creator versions previous to 2.1
         /// </summary>
@@ -0,0 +1,37 @@
+// BuildControl.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <intrin.h>
+
+#include "BuildControl.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region Functions
+
+void R3ALInterop::AddProgress(BuildControl* control, volatile long long BuildControl::* counter, long long amount)
+{
+	if (control)
+		_InterlockedExchangeAdd64(&(control->*counter), amount);
+}
+
+long long R3ALInterop::ReadProgress(BuildControl* control, volatile long long BuildControl::* counter)
+{
+	// Plain 64-bit reads can tear on x86
+	return control ? _InterlockedCompareExchange64(&(control->*counter), 0, 0) : 0;
+}
+
+#pragma endregion
@@ -0,0 +1,50 @@
+// BuildControl.hpp
+// Cancellation flag and progress counters shared between a build and its caller
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+namespace R3ALInterop
+{
+
+	// Native code checks Cancelled between units of work and adds to the
+	// counters as it goes, the owner polls them from another thread. Every
+	// function below accepts nullptr, for builds nobody is watching.
+	struct BuildControl
+	{
+		volatile bool Cancelled;
+		volatile long long BlocksTotal;   // 4x4 blocks of the textures loaded, see MBuildProgress
+		volatile long long BlocksLoaded;
+		volatile long long BytesWritten;  // Copied model files
+
+		BuildControl()
+			: Cancelled(false), BlocksTotal(0), BlocksLoaded(0), BytesWritten(0)
+		{
+		}
+	};
+
+	inline bool IsCancelled(const BuildControl* control)
+	{
+		return control && control->Cancelled;
+	}
+
+	// Atomic add to one of the counters.
+	void AddProgress(BuildControl* control, volatile long long BuildControl::* counter, long long amount);
+
+	// Atomic read of one of the counters.
+	long long ReadProgress(BuildControl* control, volatile long long BuildControl::* counter);
+
+}
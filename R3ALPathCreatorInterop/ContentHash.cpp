@@ -0,0 +1,157 @@
+// ContentHash.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "ContentHash.hpp"
+#include "Parallel.hpp"
+
+using namespace R3ALInterop;
+
+namespace
+{
+	const unsigned long long Prime1 = 0x9E3779B185EBCA87ULL;
+	const unsigned long long Prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+	unsigned long long Rotate(unsigned long long x, int bits)
+	{
+		return (x << bits) | (x >> (64 - bits));
+	}
+
+	// splitmix64 finalizer
+	unsigned long long Avalanche(unsigned long long x)
+	{
+		x ^= x >> 30;
+		x *= 0xBF58476D1CE4E5B9ULL;
+		x ^= x >> 27;
+		x *= 0x94D049BB133111EBULL;
+		x ^= x >> 31;
+		return x;
+	}
+}
+
+#pragma region ContentHasher
+
+ContentHasher::ContentHasher(unsigned long long seed)
+	: _state(seed ^ Prime1), _length(0), _tailSize(0)
+{
+}
+
+void ContentHasher::Mix(unsigned long long word)
+{
+	_state ^= Rotate(word * Prime2, 31) * Prime1;
+	_state = Rotate(_state, 27) * Prime1 + Prime2;
+}
+
+void ContentHasher::Update(const void* data, size_t size)
+{
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	_length += size;
+
+	if (_tailSize)
+	{
+		size_t take = std::min(size, 8 - _tailSize);
+		std::memcpy(_tail + _tailSize, p, take);
+		_tailSize += take;
+		p += take;
+		size -= take;
+
+		if (_tailSize < 8)
+			return;
+
+		unsigned long long word;
+		std::memcpy(&word, _tail, 8);
+		Mix(word);
+		_tailSize = 0;
+	}
+
+	for (; size >= 8; p += 8, size -= 8)
+	{
+		unsigned long long word;
+		std::memcpy(&word, p, 8);
+		Mix(word);
+	}
+
+	std::memcpy(_tail, p, size);
+	_tailSize = size;
+}
+
+void ContentHasher::Update(const std::string& str)
+{
+	unsigned long long length = str.length();
+	Update(&length, sizeof(length));
+	Update(str.data(), str.length());
+}
+
+unsigned long long ContentHasher::Final() const
+{
+	unsigned long long state = _state;
+	unsigned long long word = 0;
+
+	std::memcpy(&word, _tail, _tailSize);
+	state ^= Rotate(word * Prime2, 31) * Prime1;
+
+	return Avalanche(state ^ _length);
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+void R3ALInterop::HashFiles(const std::vector<std::vector<std::string>>& groups, std::vector<unsigned long long>& hashes,
+	std::vector<std::string>& errors)
+{
+	hashes.assign(groups.size(), 0);
+	errors.assign(groups.size(), std::string());
+
+	unsigned int workers = WorkerCount();
+	std::vector<std::vector<char>> buffers(workers, std::vector<char>(1024 * 1024));
+
+	ParallelFor(groups.size(), workers, [&](size_t i, unsigned int worker)
+	{
+		ContentHasher hasher;
+		std::vector<char>& buffer = buffers[worker];
+
+		for (const std::string& fileName : groups[i])
+		{
+			std::ifstream file(fileName, std::ios::binary);
+
+			if (!file)
+			{
+				errors[i] = "Failed to open \"" + fileName + "\".";
+				return;
+			}
+
+			while (file)
+			{
+				file.read(buffer.data(), buffer.size());
+				hasher.Update(buffer.data(), static_cast<size_t>(file.gcount()));
+			}
+
+			if (!file.eof())
+			{
+				errors[i] = "Failed to read \"" + fileName + "\".";
+				return;
+			}
+		}
+
+		hashes[i] = hasher.Final();
+	});
+}
+
+#pragma endregion
@@ -0,0 +1,57 @@
+// ContentHash.hpp
+// Fast non-cryptographic 64-bit hashing of pixel and file contents
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace R3ALInterop
+{
+
+	// Streaming 64-bit hash. Good for spotting duplicates, but equal hashes
+	// should still be confirmed with a byte comparison where it matters.
+	class ContentHasher
+	{
+	private:
+		unsigned long long _state;
+		unsigned long long _length;
+		unsigned char _tail[8];
+		size_t _tailSize;
+
+		void Mix(unsigned long long word);
+
+	public:
+
+		// Constructor.
+		ContentHasher(unsigned long long seed = 0);
+
+		void Update(const void* data, size_t size);
+		void Update(const std::string& str);
+
+		// Returns the hash of everything passed to Update so far.
+		unsigned long long Final() const;
+
+	};
+
+	// Hashes each group of files as one stream of bytes, groups in parallel.
+	// errors[i] is empty when every file of groups[i] was read.
+	void HashFiles(const std::vector<std::vector<std::string>>& groups, std::vector<unsigned long long>& hashes,
+		std::vector<std::string>& errors);
+
+}
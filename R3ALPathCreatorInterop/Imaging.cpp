@@ -0,0 +1,148 @@
+// Imaging.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <atomic>
+#include <cstdio>
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#include <Magick++.h>
+#include <OutputLog.hpp>
+
+#include "Imaging.hpp"
+#include "Metrics.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region RgbaImage
+
+RgbaImage::RgbaImage()
+	: Width(0), Height(0)
+{
+}
+
+RgbaImage::RgbaImage(unsigned int width, unsigned int height)
+	: Width(0), Height(0)
+{
+	Resize(width, height);
+}
+
+void RgbaImage::Resize(unsigned int width, unsigned int height)
+{
+	Width = width;
+	Height = height;
+	Pixels.assign(PixelCount() * 4, 0);
+}
+
+#pragma endregion
+
+#pragma region TemporaryFile
+
+TemporaryFile::TemporaryFile(const std::string& extension)
+{
+	static std::atomic<unsigned long> counter(0);
+
+	char directory[MAX_PATH + 1];
+	DWORD length = GetTempPathA(MAX_PATH + 1, directory);
+
+	_fileName = std::string(directory, length) + "R3AL_" + std::to_string(GetCurrentProcessId()) + "_" +
+		std::to_string(counter++) + extension;
+}
+
+TemporaryFile::~TemporaryFile()
+{
+	std::remove(_fileName.c_str());
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+bool R3ALInterop::ProbeImage(const std::string& fileName, unsigned int& width, unsigned int& height, std::string& error)
+{
+	try
+	{
+		Magick::Image source;
+		source.ping(fileName);
+
+		width = source.columns();
+		height = source.rows();
+	}
+	catch (std::exception& e)
+	{
+		error = "Failed to read image \"" + fileName + "\": " + e.what();
+		return false;
+	}
+
+	return true;
+}
+
+bool R3ALInterop::DecodeImage(const std::string& fileName, RgbaImage& image, RCT3Debugging::OutputLog& log)
+{
+	std::shared_ptr<BuildMetrics> metrics = MetricsFor(log);
+	StageTimer timer(metrics, Stage::Decode);
+
+	try
+	{
+		Magick::Image source;
+		source.read(fileName);
+
+		image.Resize(source.columns(), source.rows());
+		source.write(0, 0, image.Width, image.Height, "RGBA", Magick::CharPixel, image.Pixels.data());
+	}
+	catch (std::exception& e)
+	{
+		log.Error("Failed to decode image \"" + fileName + "\": " + e.what());
+		return false;
+	}
+
+	metrics->Add(Counter::BytesDecoded, image.Pixels.size());
+
+	return true;
+}
+
+bool R3ALInterop::EncodeImage(const std::string& fileName, const RgbaImage& image, RCT3Debugging::OutputLog& log)
+{
+	std::string error;
+
+	if (!EncodeImage(fileName, image, error))
+	{
+		log.Error(error);
+		return false;
+	}
+
+	return true;
+}
+
+bool R3ALInterop::EncodeImage(const std::string& fileName, const RgbaImage& image, std::string& error)
+{
+	try
+	{
+		Magick::Image destination(image.Width, image.Height, "RGBA", Magick::CharPixel, image.Pixels.data());
+		destination.write(fileName);
+	}
+	catch (std::exception& e)
+	{
+		error = "Failed to encode image \"" + fileName + "\": " + e.what();
+		return false;
+	}
+
+	return true;
+}
+
+#pragma endregion
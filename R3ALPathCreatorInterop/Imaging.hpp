@@ -0,0 +1,92 @@
+// Imaging.hpp
+// Native RGBA image buffers decoded/encoded through GraphicsMagick
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace RCT3Debugging
+{
+	class OutputLog;
+}
+
+namespace R3ALInterop
+{
+
+	// 8-bit per channel RGBA image, rows stored top to bottom without padding.
+	struct RgbaImage
+	{
+		unsigned int Width;
+		unsigned int Height;
+		std::vector<unsigned char> Pixels;
+
+		// Constructor.
+		RgbaImage();
+
+		// Constructor, allocates a zeroed width x height image.
+		RgbaImage(unsigned int width, unsigned int height);
+
+		// Reallocates the pixel buffer for a width x height image.
+		void Resize(unsigned int width, unsigned int height);
+
+		size_t PixelCount() const { return static_cast<size_t>(Width) * Height; }
+
+		unsigned char* Row(unsigned int y) { return &Pixels[static_cast<size_t>(y) * Width * 4]; }
+		const unsigned char* Row(unsigned int y) const { return &Pixels[static_cast<size_t>(y) * Width * 4]; }
+	};
+
+	// Unique file name in the temp directory. The file, if one was created,
+	// is deleted when this goes out of scope.
+	class TemporaryFile
+	{
+	private:
+		std::string _fileName;
+
+		TemporaryFile(const TemporaryFile&) = delete;
+		TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+	public:
+
+		// Constructor.
+		TemporaryFile(const std::string& extension);
+
+		// Destructor.
+		~TemporaryFile();
+
+		const std::string& FileName() const { return _fileName; }
+	};
+
+	// Reads the dimensions of an image file without decoding its pixels.
+	//     * Returns false and sets `error` on failure
+	bool ProbeImage(const std::string& fileName, unsigned int& width, unsigned int& height, std::string& error);
+
+	// Decodes an image file into RGBA.
+	//     * Registers errors to the OutputLog, returns false on failure
+	bool DecodeImage(const std::string& fileName, RgbaImage& image, RCT3Debugging::OutputLog& log);
+
+	// Encodes an RGBA image to a file, format chosen from the extension.
+	// Used to hand preprocessed pixels to RCT3Asset::TexImage/FtxImage, which
+	// only read from files.
+	//     * Registers errors to the OutputLog, returns false on failure
+	bool EncodeImage(const std::string& fileName, const RgbaImage& image, RCT3Debugging::OutputLog& log);
+
+	// Same, safe to call from worker threads: errors are returned instead of logged.
+	bool EncodeImage(const std::string& fileName, const RgbaImage& image, std::string& error);
+
+}
@@ -0,0 +1,170 @@
+// MBatchBuild.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MBatchBuild.hpp"
+#include "MStagedInstall.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Diagnostics;
+
+#pragma region Private
+
+void MBatchBuild::PrefetchLoop()
+{
+	array<unsigned char>^ buffer = gcnew array<unsigned char>(1024 * 1024);
+
+	try
+	{
+		for (int i = 0; i < _projects->Count; i++)
+		{
+			Stopwatch^ stall = Stopwatch::StartNew();
+			_slots->Wait();
+			PrefetchStallTime += stall->ElapsedMilliseconds;
+
+			if (_stopping)
+				break;
+
+			Stopwatch^ work = Stopwatch::StartNew();
+
+			try
+			{
+				Prefetch(_projects[i], buffer);
+			}
+			catch (Exception^)
+			{
+				// Missing or unreadable inputs fail the project's own build,
+				// the remaining projects are still prefetched
+			}
+
+			PrefetchTime += work->ElapsedMilliseconds;
+
+			_ready->Add(i);
+		}
+	}
+	finally
+	{
+		_ready->CompleteAdding();
+	}
+}
+
+void MBatchBuild::Prefetch(IOvlProject^ project, array<unsigned char>^ buffer)
+{
+	for each (String^ file in project->GetInputs(_outputs))
+	{
+		if (!String::IsNullOrWhiteSpace(file) && !_stopping)
+			ReadAhead(file, buffer);
+	}
+}
+
+void MBatchBuild::ReadAhead(String^ file, array<unsigned char>^ buffer)
+{
+	try
+	{
+		FileStream^ stream = gcnew FileStream(file, FileMode::Open, FileAccess::Read, FileShare::Read, 4096, FileOptions::SequentialScan);
+
+		try
+		{
+			while (stream->Read(buffer, 0, buffer->Length) > 0)
+				;
+		}
+		finally
+		{
+			delete stream;
+		}
+	}
+	catch (IOException^)
+	{
+	}
+	catch (UnauthorizedAccessException^)
+	{
+	}
+	catch (ArgumentException^)
+	{
+	}
+}
+
+#pragma endregion
+
+#pragma region Public
+
+MBatchBuild::MBatchBuild()
+	: _projects(gcnew List<IOvlProject^>()), _targets(gcnew List<MBuildTargets^>())
+{
+	PrefetchDepth = 1;
+}
+
+void MBatchBuild::Add(IOvlProject^ project, MBuildTargets^ targets)
+{
+	_projects->Add(project);
+	_targets->Add(targets);
+}
+
+bool MBatchBuild::Build(MOvlOutputs outputs, MOutputLog^ log)
+{
+	PrefetchTime = 0;
+	PrefetchStallTime = 0;
+	BuildTime = 0;
+	BuildStallTime = 0;
+
+	_outputs = outputs;
+	_ready = gcnew BlockingCollection<int>();
+	_slots = gcnew SemaphoreSlim(Math::Max(PrefetchDepth, 1));
+	_stopping = false;
+
+	Thread^ thread = gcnew Thread(gcnew ThreadStart(this, &MBatchBuild::PrefetchLoop));
+	thread->IsBackground = true;
+	thread->Start();
+
+	int failed = 0;
+
+	try
+	{
+		for (;;)
+		{
+			int i;
+
+			Stopwatch^ stall = Stopwatch::StartNew();
+			bool more = _ready->TryTake(i, Timeout::Infinite);
+			BuildStallTime += stall->ElapsedMilliseconds;
+
+			if (!more)
+				break;
+
+			// The next project can be read while this one builds
+			_slots->Release();
+
+			Stopwatch^ work = Stopwatch::StartNew();
+
+			if (!MStagedInstall::Install(_projects[i], outputs, _targets[i], log, OutputCache))
+				failed++;
+
+			BuildTime += work->ElapsedMilliseconds;
+		}
+	}
+	finally
+	{
+		_stopping = true;
+		_slots->Release();
+		thread->Join();
+	}
+
+	log->Info(String::Format("Batch: {0} projects, {1} failed. Read ahead {2} ms, stalled {3} ms. Build {4} ms, stalled {5} ms.",
+		_projects->Count, failed, PrefetchTime, PrefetchStallTime, BuildTime, BuildStallTime));
+
+	return failed == 0;
+}
+
+#pragma endregion
@@ -0,0 +1,82 @@
+// MBatchBuild.hpp
+// Builds a list of projects with the next one read ahead
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+#include "MOutputCache.hpp"
+
+using namespace System::Collections::Concurrent;
+using namespace System::Threading;
+
+namespace R3ALInterop
+{
+
+	// Installs projects one after the other through MStagedInstall while a
+	// background thread reads ahead: the input files of the next projects
+	// are read once so the build gets them from the OS file cache. Reading
+	// ahead stops PrefetchDepth projects in front of the build, and nothing
+	// read is kept in the process.
+	//
+	// Prefetching never fails the batch, files it cannot read are reported
+	// by the build itself.
+	public ref class MBatchBuild
+	{
+	private:
+		List<IOvlProject^>^ _projects;
+		List<MBuildTargets^>^ _targets;
+
+		MOvlOutputs _outputs;
+		BlockingCollection<int>^ _ready;  // Prefetched projects, in order
+		SemaphoreSlim^ _slots;            // Free prefetch slots, PrefetchDepth at most
+		volatile bool _stopping;
+
+		// Read ahead thread.
+		void PrefetchLoop();
+
+		// Reads one project's inputs ahead.
+		void Prefetch(IOvlProject^ project, array<unsigned char>^ buffer);
+
+		// Reads a file to the end, discarding the data.
+		static void ReadAhead(String^ file, array<unsigned char>^ buffer);
+
+	public:
+		property int PrefetchDepth;      // Projects read ahead of the build, 1 by default
+		property MOutputCache^ OutputCache; // Optional, projects are built through it
+
+		// Set by Build, in milliseconds.
+		property long long PrefetchTime;      // Reading ahead
+		property long long PrefetchStallTime; // Read ahead waiting for a free slot (build is the bottleneck)
+		property long long BuildTime;         // Building and installing
+		property long long BuildStallTime;    // Build waiting for the read ahead (I/O is the bottleneck)
+
+		// Constructor.
+		MBatchBuild();
+
+		// Adds a project to install into `targets`.
+		void Add(IOvlProject^ project, MBuildTargets^ targets);
+
+		// Installs `outputs` of every project, in the order they were added.
+		// A failed project does not stop the others.
+		//     * Registers errors to the MOutputLog, returns false if any project failed
+		bool Build(MOvlOutputs outputs, MOutputLog^ log);
+
+	};
+
+}
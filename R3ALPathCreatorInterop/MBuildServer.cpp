@@ -0,0 +1,417 @@
+// MBuildServer.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MBuildServer.hpp"
+#include "MStagedInstall.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region MBuildServer
+
+MBuildServer::MBuildServer(String^ pipeName)
+	: _pipeName(pipeName), _running(false)
+{
+	_stopping = gcnew ManualResetEvent(false);
+	_jobLock = gcnew Object();
+}
+
+MBuildServer::~MBuildServer()
+{
+	Stop();
+	delete _stopping;
+}
+
+void MBuildServer::Start()
+{
+	if (_running)
+		return;
+
+	_running = true;
+	_stopping->Reset();
+	_thread = gcnew Thread(gcnew ThreadStart(this, &MBuildServer::Serve));
+	_thread->IsBackground = true;
+	_thread->Start();
+}
+
+void MBuildServer::Stop()
+{
+	if (!_running)
+		return;
+
+	_running = false;
+
+	// Wakes a thread waiting for a client
+	_stopping->Set();
+
+	// Waits for the current job, then unblocks a client that stays connected
+	// without sending another one
+	Monitor::Enter(_jobLock);
+	try
+	{
+		NamedPipeServerStream^ pipe = _pipe;
+
+		if (pipe != nullptr)
+			delete pipe;
+	}
+	finally
+	{
+		Monitor::Exit(_jobLock);
+	}
+
+	_thread->Join();
+	_thread = nullptr;
+}
+
+void MBuildServer::Serve()
+{
+	while (_running)
+	{
+		NamedPipeServerStream^ pipe = gcnew NamedPipeServerStream(_pipeName, PipeDirection::InOut, 1, PipeTransmissionMode::Byte,
+			PipeOptions::Asynchronous);
+
+		try
+		{
+			IAsyncResult^ connecting = pipe->BeginWaitForConnection(nullptr, nullptr);
+			array<WaitHandle^>^ handles = { connecting->AsyncWaitHandle, _stopping };
+
+			if (WaitHandle::WaitAny(handles) == 1)
+				break;
+
+			pipe->EndWaitForConnection(connecting);
+
+			Monitor::Enter(_jobLock);
+			try
+			{
+				// Stop may have run between the wait and here
+				if (!_running)
+					break;
+
+				_pipe = pipe;
+			}
+			finally
+			{
+				Monitor::Exit(_jobLock);
+			}
+
+			StreamReader^ reader = gcnew StreamReader(pipe, Encoding::UTF8);
+			StreamWriter^ writer = gcnew StreamWriter(pipe, gcnew UTF8Encoding(false));
+			writer->AutoFlush = true;
+
+			while (_running && RunJob(reader, writer))
+			{
+			}
+		}
+		catch (ObjectDisposedException^)
+		{
+			// Stopped
+		}
+		catch (IOException^)
+		{
+			// Client went away
+		}
+		finally
+		{
+			Monitor::Enter(_jobLock);
+			try
+			{
+				_pipe = nullptr;
+			}
+			finally
+			{
+				Monitor::Exit(_jobLock);
+			}
+
+			delete pipe;
+		}
+	}
+}
+
+bool MBuildServer::RunJob(TextReader^ reader, TextWriter^ writer)
+{
+	String^ header = reader->ReadLine();
+
+	while (header != nullptr && String::IsNullOrWhiteSpace(header))
+		header = reader->ReadLine();
+
+	if (header == nullptr)
+		return false;
+
+	Monitor::Enter(_jobLock);
+	try
+	{
+		BuildJob(header, reader, writer);
+	}
+	finally
+	{
+		Monitor::Exit(_jobLock);
+	}
+
+	return true;
+}
+
+void MBuildServer::BuildJob(String^ header, TextReader^ reader, TextWriter^ writer)
+{
+	Diagnostics::Stopwatch^ total = Diagnostics::Stopwatch::StartNew();
+
+	MOutputLog^ log = gcnew MOutputLog();
+	MBuildTargets^ targets = gcnew MBuildTargets();
+	MOvlOutputs outputs = MOvlOutputs::All;
+	String^ error = nullptr;
+	int sent = 0;  // Log lines already sent
+
+	try
+	{
+		// Loader, staging and Build may throw anything, the client gets it as an error
+		try
+		{
+			IOvlProject^ project = ReadJob(header->Trim(), reader, targets, outputs, error);
+
+			if (project == nullptr)
+			{
+				log->Error(error);
+			}
+			else
+			{
+				// Outputs are installed together once all of them were built
+				MStagedInstall^ install = gcnew MStagedInstall();
+				MBuildTargets^ staged = install->StageTargets(targets);
+
+				array<MOvlOutputs>^ order = { MOvlOutputs::Texture, MOvlOutputs::Icon, MOvlOutputs::Stub, MOvlOutputs::Blank, MOvlOutputs::Models };
+
+				for each (MOvlOutputs output in order)
+				{
+					if ((outputs & output) == MOvlOutputs::None)
+						continue;
+
+					Diagnostics::Stopwatch^ watch = Diagnostics::Stopwatch::StartNew();
+
+					try
+					{
+						project->Build(output, staged, log);
+					}
+					catch (Exception^ e)
+					{
+						log->Error(String::Format("{0}: {1}", output, e->Message));
+					}
+
+					sent = SendLog(log, writer, sent);
+					writer->WriteLine("PROGRESS {0} {1}", output, watch->ElapsedMilliseconds);
+				}
+
+				try
+				{
+					if (!log->GetErrorCount())
+						install->Commit();
+					else
+						log->Error("Build failed, nothing was installed.");
+				}
+				catch (Exception^ e)
+				{
+					log->Error(String::Format("Install failed: {0}", e->Message));
+				}
+				finally
+				{
+					delete install;
+				}
+			}
+		}
+		catch (Exception^ e)
+		{
+			log->Error(String::Format("Job failed: {0}", e->Message));
+		}
+
+		SendLog(log, writer, sent);
+		writer->WriteLine("DONE {0} {1}", log->GetErrorCount(), total->ElapsedMilliseconds);
+	}
+	finally
+	{
+		delete log;
+	}
+}
+
+int MBuildServer::SendLog(MOutputLog^ log, TextWriter^ writer, int sent)
+{
+	// OutputLog can only be read back through a file
+	String^ logFile = Path::GetTempFileName();
+
+	try
+	{
+		log->SaveToFile(logFile);
+
+		array<String^>^ lines = File::ReadAllLines(logFile);
+
+		for (int i = sent; i < lines->Length; i++)
+			writer->WriteLine("LOG {0}", lines[i]);
+
+		return Math::Max(sent, lines->Length);
+	}
+	finally
+	{
+		File::Delete(logFile);
+	}
+}
+
+IOvlProject^ MBuildServer::ReadJob(String^ header, TextReader^ reader, MBuildTargets^ targets, MOvlOutputs% outputs, String^% error)
+{
+	IOvlProject^ project = nullptr;
+
+	if (header->Equals("PATH", StringComparison::OrdinalIgnoreCase))
+	{
+		project = gcnew MPath();
+	}
+	else if (header->Equals("QUEUE", StringComparison::OrdinalIgnoreCase))
+	{
+		project = gcnew MQueue();
+	}
+	else if (header->StartsWith("PROJECT ", StringComparison::OrdinalIgnoreCase))
+	{
+		if (Loader == nullptr)
+		{
+			error = "This server does not load project files.";
+		}
+		else
+		{
+			try
+			{
+				project = Loader(header->Substring(8)->Trim());
+			}
+			catch (Exception^ e)
+			{
+				error = String::Format("Cannot load \"{0}\": {1}", header->Substring(8)->Trim(), e->Message);
+			}
+		}
+	}
+	else
+	{
+		error = String::Format("Unknown job \"{0}\".", header);
+	}
+
+	// Always read up to END, so the next job starts on its header
+	for (String^ line = reader->ReadLine(); line != nullptr; line = reader->ReadLine())
+	{
+		if (line->Trim()->Equals("END", StringComparison::OrdinalIgnoreCase))
+			break;
+
+		if (error != nullptr || String::IsNullOrWhiteSpace(line))
+			continue;
+
+		int split = line->IndexOf('=');
+
+		if (split < 0)
+		{
+			error = String::Format("Expected Name=Value, got \"{0}\".", line);
+			continue;
+		}
+
+		String^ name = line->Substring(0, split)->Trim();
+		String^ value = line->Substring(split + 1);
+
+		if (name->StartsWith("Target.", StringComparison::OrdinalIgnoreCase))
+		{
+			SetProperty(targets, name->Substring(7), value, error);
+		}
+		else if (name->Equals("Outputs", StringComparison::OrdinalIgnoreCase))
+		{
+			if (!Enum::TryParse<MOvlOutputs>(value, true, outputs))
+				error = String::Format("Unknown outputs \"{0}\".", value);
+		}
+		else if (project != nullptr)
+		{
+			SetProperty(project, name, value, error);
+		}
+	}
+
+	return error == nullptr ? project : nullptr;
+}
+
+bool MBuildServer::SetProperty(Object^ target, String^ name, String^ value, String^% error)
+{
+	Reflection::PropertyInfo^ property = target->GetType()->GetProperty(name);
+
+	if (property == nullptr || !property->CanWrite)
+	{
+		error = String::Format("Unknown property \"{0}\".", name);
+		return false;
+	}
+
+	Type^ type = property->PropertyType;
+	Object^ converted;
+
+	try
+	{
+		if (type == String::typeid)
+			converted = value;
+		else if (type == MPathSection::typeid)
+			converted = MPathSection(value);
+		else if (type == List<String^>::typeid)
+			converted = gcnew List<String^>(value->Split(gcnew array<wchar_t>{ '|' }, StringSplitOptions::RemoveEmptyEntries));
+		else if (type->IsEnum)
+			converted = Enum::Parse(type, value, true);
+		else
+			converted = System::Convert::ChangeType(value, type, Globalization::CultureInfo::InvariantCulture);
+
+		property->SetValue(target, converted, nullptr);
+	}
+	catch (Exception^ e)
+	{
+		error = String::Format("Invalid value for \"{0}\": {1}", name, e->Message);
+		return false;
+	}
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma region MBuildClient
+
+unsigned int MBuildClient::Submit(String^ pipeName, String^ job, Action<String^>^ onLine, int timeout)
+{
+	NamedPipeClientStream^ pipe = gcnew NamedPipeClientStream(".", pipeName, PipeDirection::InOut);
+
+	try
+	{
+		pipe->Connect(timeout);
+
+		StreamReader^ reader = gcnew StreamReader(pipe, Encoding::UTF8);
+		StreamWriter^ writer = gcnew StreamWriter(pipe, gcnew UTF8Encoding(false));
+
+		writer->Write(job->TrimEnd());
+		writer->WriteLine();
+
+		if (!job->TrimEnd()->EndsWith("END", StringComparison::OrdinalIgnoreCase))
+			writer->WriteLine("END");
+
+		writer->Flush();
+
+		for (String^ line = reader->ReadLine(); line != nullptr; line = reader->ReadLine())
+		{
+			if (onLine != nullptr)
+				onLine(line);
+
+			if (line->StartsWith("DONE "))
+				return UInt32::Parse(line->Split(' ')[1]);
+		}
+	}
+	finally
+	{
+		delete pipe;
+	}
+
+	throw gcnew IOException("Build server closed the connection before the job finished.");
+}
+
+#pragma endregion
@@ -0,0 +1,114 @@
+// MBuildServer.hpp
+// Long running build service that accepts jobs over a named pipe
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+#include "MPath.hpp"
+#include "MQueue.hpp"
+#include "MProjectWatcher.hpp"
+
+using namespace System::IO::Pipes;
+using namespace System::Threading;
+
+namespace R3ALInterop
+{
+
+	// Builds projects for clients connecting to a named pipe, so the asset
+	// library stays loaded between builds. Jobs run one at
+	// a time in the order they arrive.
+	//
+	// The protocol is line based UTF-8. A job is a header line, any number of
+	// Name=Value lines and END:
+	//
+	//     PATH | QUEUE            Properties of an MPath/MQueue by name
+	//     PROJECT <file>          Loaded through Loader
+	//     Target.<Name>=<value>   MBuildTargets properties
+	//     Outputs=<value>         MOvlOutputs, All if missing
+	//     END
+	//
+	// List properties take values separated by '|'. After each output the
+	// server sends LOG <line> for each line it logged, then PROGRESS <output>
+	// <ms>. The last LOG lines and DONE <errors> <ms> follow when the job is
+	// finished. The native OutputLog has no per-line callback, so lines
+	// cannot be sent while an output is still building.
+	public ref class MBuildServer
+	{
+	private:
+		String^ _pipeName;
+		Thread^ _thread;
+		NamedPipeServerStream^ _pipe;  // Connected pipe, only set while a client is served
+		ManualResetEvent^ _stopping;   // Cancels the wait for a client
+		Object^ _jobLock;              // Held while a job runs
+		volatile bool _running;
+
+	public:
+		static initonly String^ DefaultPipeName = "R3ALPathCreator";
+
+		property OvlProjectLoader^ Loader;  // Required for PROJECT jobs
+
+		// Constructor.
+		MBuildServer(String^ pipeName);
+
+		// Dispose
+		~MBuildServer();
+
+		// Starts serving on a background thread.
+		void Start();
+
+		// Stops accepting clients and waits for the current job.
+		void Stop();
+
+		// Runs one job read from `reader`, writing the responses to `writer`.
+		// Exceptions thrown while loading or building the project are
+		// reported to the client as errors.
+		//     * Returns false if the connection ended before a job was read
+		bool RunJob(TextReader^ reader, TextWriter^ writer);
+
+	private:
+
+		void Serve();
+
+		// Reads the rest of the job after `header`, builds it and writes the responses.
+		void BuildJob(String^ header, TextReader^ reader, TextWriter^ writer);
+
+		// Writes the log lines after the first `sent` as LOG responses.
+		//     * Returns the number of lines sent so far
+		static int SendLog(MOutputLog^ log, TextWriter^ writer, int sent);
+
+		IOvlProject^ ReadJob(String^ header, TextReader^ reader, MBuildTargets^ targets, MOvlOutputs% outputs, String^% error);
+
+		// Sets a property of `target` from its text form.
+		static bool SetProperty(Object^ target, String^ name, String^ value, String^% error);
+
+	};
+
+	// Client side of MBuildServer.
+	public ref class MBuildClient abstract sealed
+	{
+	public:
+
+		// Sends one job and passes each response line to `onLine`.
+		//     * Returns the error count reported by the server
+		//     * Throws System::Exception-inherited classes
+		static unsigned int Submit(String^ pipeName, String^ job, Action<String^>^ onLine, int timeout);
+
+	};
+
+}
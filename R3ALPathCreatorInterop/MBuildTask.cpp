@@ -0,0 +1,226 @@
+// MBuildTask.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MBuildTask.hpp"
+
+using namespace R3ALInterop;
+
+namespace R3ALInterop
+{
+
+	// State of one MBuildTask::Run call.
+	ref class BuildTaskState
+	{
+	private:
+		MBuildJob^ _job;
+		IProgress<MBuildProgress^>^ _progress;
+		CancellationToken _token;
+		MBuildControl^ _control;
+		Object^ _reportLock;  // Held while a snapshot reads _control
+		bool _finished;       // Set under _reportLock before _control is deleted
+
+		// Timer callback. Deleting the timer does not wait for a callback
+		// already running, so it checks _finished under the lock instead.
+		void Report(Object^)
+		{
+			Monitor::Enter(_reportLock);
+			try
+			{
+				if (!_finished)
+					_progress->Report(_control->Snapshot(_job->Output));
+			}
+			finally
+			{
+				Monitor::Exit(_reportLock);
+			}
+		}
+
+	public:
+		BuildTaskState(MBuildJob^ job, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+			: _job(job), _progress(progress), _token(token), _reportLock(gcnew Object()), _finished(false)
+		{
+		}
+
+		void Execute()
+		{
+			_token.ThrowIfCancellationRequested();
+
+			_control = gcnew MBuildControl();
+
+			CancellationTokenRegistration registration = _token.Register(gcnew Action(_control, &MBuildControl::Cancel));
+			Timer^ timer = nullptr;
+
+			if (_progress != nullptr)
+				timer = gcnew Timer(gcnew TimerCallback(this, &BuildTaskState::Report), nullptr, 100, 100);
+
+			try
+			{
+				_job->Run(_control);
+			}
+			catch (OperationCanceledException^)
+			{
+				// Native code and MBuildControl::CopyFile do not know the
+				// token, rethrow with it so the task ends as canceled
+				_token.ThrowIfCancellationRequested();
+				throw;
+			}
+			finally
+			{
+				registration.Dispose();
+
+				if (timer != nullptr)
+				{
+					delete timer;
+					Report(nullptr);
+				}
+
+				Monitor::Enter(_reportLock);
+				try
+				{
+					_finished = true;
+				}
+				finally
+				{
+					Monitor::Exit(_reportLock);
+				}
+
+				delete _control;
+			}
+		}
+	};
+
+}
+
+#pragma region MBuildControl
+
+MBuildControl::MBuildControl()
+	: _control(new BuildControl())
+{
+}
+
+MBuildControl::~MBuildControl()
+{
+	this->!MBuildControl();
+	GC::SuppressFinalize(this);
+}
+
+MBuildControl::!MBuildControl()
+{
+	delete _control;
+	_control = nullptr;
+}
+
+void MBuildControl::Cancel()
+{
+	if (_control)
+		_control->Cancelled = true;
+}
+
+bool MBuildControl::IsCancelled::get()
+{
+	return R3ALInterop::IsCancelled(_control);
+}
+
+MBuildProgress^ MBuildControl::Snapshot(MOvlOutputs output)
+{
+	MBuildProgress^ progress = gcnew MBuildProgress();
+	progress->Output = output;
+	progress->BlocksTotal = ReadProgress(_control, &BuildControl::BlocksTotal);
+	progress->BlocksLoaded = ReadProgress(_control, &BuildControl::BlocksLoaded);
+	progress->BytesWritten = ReadProgress(_control, &BuildControl::BytesWritten);
+
+	return progress;
+}
+
+BuildControl* MBuildControl::Native()
+{
+	return _control;
+}
+
+void MBuildControl::ThrowIfCancelled(MBuildControl^ control)
+{
+	if (control != nullptr && control->IsCancelled)
+		throw gcnew OperationCanceledException();
+}
+
+void MBuildControl::CopyFile(String^ source, String^ destination)
+{
+	array<unsigned char>^ buffer = gcnew array<unsigned char>(1024 * 1024);
+
+	FileStream^ input = File::OpenRead(source);
+	FileStream^ output = nullptr;
+
+	try
+	{
+		output = gcnew FileStream(destination, FileMode::CreateNew, FileAccess::Write);
+
+		int read;
+
+		while ((read = input->Read(buffer, 0, buffer->Length)) > 0)
+		{
+			if (IsCancelled)
+				throw gcnew OperationCanceledException();
+
+			output->Write(buffer, 0, read);
+			AddProgress(_control, &BuildControl::BytesWritten, read);
+		}
+	}
+	catch (Exception^)
+	{
+		// Never leave a partial copy behind
+		if (output != nullptr)
+		{
+			delete output;
+			output = nullptr;
+			File::Delete(destination);
+		}
+
+		throw;
+	}
+	finally
+	{
+		delete input;
+		delete output;
+	}
+}
+
+void MBuildControl::CopyOvlFiles(List<String^>^ ovlFileNames, String^ destinationDirectory)
+{
+	for each (String^ ovlFileName in ovlFileNames)
+		util::CheckOvlFile(ovlFileName, destinationDirectory);
+
+	for each (String^ ovlFileName in ovlFileNames)
+	{
+		String^ unique = ovlFileName->Replace("common.ovl", "unique.ovl");
+
+		CopyFile(ovlFileName, destinationDirectory + Path::GetFileName(ovlFileName));
+		CopyFile(unique, destinationDirectory + Path::GetFileName(unique));
+	}
+}
+
+#pragma endregion
+
+#pragma region MBuildTask
+
+Task^ MBuildTask::Run(MBuildJob^ job, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	BuildTaskState^ state = gcnew BuildTaskState(job, progress, token);
+
+	return Task::Factory->StartNew(gcnew Action(state, &BuildTaskState::Execute), token,
+		TaskCreationOptions::LongRunning, TaskScheduler::Default);
+}
+
+#pragma endregion
@@ -0,0 +1,128 @@
+// MBuildTask.hpp
+// Runs blocking builds as cancellable tasks with progress reporting
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "Utilities.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+#include "BuildControl.hpp"
+
+using namespace System::Threading;
+using namespace System::Threading::Tasks;
+
+namespace R3ALInterop
+{
+
+	// Snapshot of a running build.
+	public ref class MBuildProgress
+	{
+	public:
+		property MOvlOutputs Output;
+		property long long BlocksTotal;   // 4x4 blocks of the textures loaded so far
+		property long long BlocksLoaded;  // Of those, blocks whose source image TexImage has read. They
+		                                  // are compressed later, inside OvlFile::Save, which reports no progress
+		property long long BytesWritten;  // Model OVL bytes copied
+	};
+
+	// Managed owner of a native BuildControl.
+	public ref class MBuildControl
+	{
+	private:
+		BuildControl* _control;
+
+	public:
+
+		// Constructor.
+		MBuildControl();
+
+		// Dispose
+		~MBuildControl();
+
+		// Finalizer
+		!MBuildControl();
+
+		// Asks the build to stop at its next check.
+		void Cancel();
+
+		property bool IsCancelled { bool get(); }
+
+		MBuildProgress^ Snapshot(MOvlOutputs output);
+
+	internal:
+
+		BuildControl* Native();
+
+		// Throws OperationCanceledException if `control` (may be null) was cancelled.
+		static void ThrowIfCancelled(MBuildControl^ control);
+
+		// Copies a file in chunks, counting bytes and checking for cancellation.
+		//     * Throws System::Exception-inherited classes
+		void CopyFile(String^ source, String^ destination);
+
+		// Like util::CopyOvlFiles, through CopyFile.
+		//     * Throws System::Exception-inherited classes
+		void CopyOvlFiles(List<String^>^ ovlFileNames, String^ destinationDirectory);
+
+	};
+
+	// One build step of a project, bound to its arguments.
+	ref class MBuildJob abstract
+	{
+	public:
+		property MOvlOutputs Output;
+
+		virtual void Run(MBuildControl^ control) = 0;
+	};
+
+	// MBuildJob for MPath/MQueue, which provide
+	// Run(MOvlOutputs, String^, MOutputLog^, MBuildControl^).
+	template<class TProject>
+	ref class ProjectBuildJob : MBuildJob
+	{
+	private:
+		TProject^ _project;
+		String^ _path;
+		MOutputLog^ _log;
+
+	public:
+		ProjectBuildJob(TProject^ project, MOvlOutputs output, String^ path, MOutputLog^ log)
+			: _project(project), _path(path), _log(log)
+		{
+			Output = output;
+		}
+
+		virtual void Run(MBuildControl^ control) override
+		{
+			_project->Run(Output, _path, _log, control);
+		}
+	};
+
+	ref class MBuildTask abstract sealed
+	{
+	public:
+
+		// Runs `job` on the thread pool. `progress` (may be null) receives a
+		// snapshot every 100 ms and one when the job ends. Cancelling `token`
+		// stops the job at its next check, the task then ends as canceled.
+		// A job that gets past its last check completes normally.
+		static Task^ Run(MBuildJob^ job, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+
+	};
+
+}
@@ -0,0 +1,523 @@
+// MBundle.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MBundle.hpp"
+#include "MStagedInstall.hpp"
+#include "ContentHash.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Threading::Tasks;
+
+namespace R3ALInterop
+{
+
+	// Body of the parallel chunk compression.
+	private ref class ChunkCompressor
+	{
+	private:
+		List<String^>^ _sources;
+		CompressionLevel _level;
+
+	public:
+		array<int>^ Files;
+		array<long long>^ Offsets;
+		array<int>^ Lengths;
+		array<array<unsigned char>^>^ Results;
+
+		ChunkCompressor(List<String^>^ sources, CompressionLevel level, int count)
+			: _sources(sources), _level(level)
+		{
+			Files = gcnew array<int>(count);
+			Offsets = gcnew array<long long>(count);
+			Lengths = gcnew array<int>(count);
+			Results = gcnew array<array<unsigned char>^>(count);
+		}
+
+		void Run(int index)
+		{
+			array<unsigned char>^ raw = gcnew array<unsigned char>(Lengths[index]);
+			FileStream^ file = gcnew FileStream(_sources[Files[index]], FileMode::Open, FileAccess::Read, FileShare::Read);
+
+			try
+			{
+				file->Seek(Offsets[index], SeekOrigin::Begin);
+
+				for (int read = 0; read < raw->Length;)
+				{
+					int n = file->Read(raw, read, raw->Length - read);
+
+					if (n == 0)
+						throw gcnew IOException("File changed while bundling: " + _sources[Files[index]]);
+
+					read += n;
+				}
+			}
+			finally
+			{
+				delete file;
+			}
+
+			MemoryStream^ compressed = gcnew MemoryStream();
+			DeflateStream^ deflate = gcnew DeflateStream(compressed, _level, true);
+			deflate->Write(raw, 0, raw->Length);
+			delete deflate;
+
+			Results[index] = compressed->ToArray();
+		}
+	};
+
+	// Body of the parallel extraction.
+	private ref class EntryExtractor
+	{
+	private:
+		MBundleReader^ _reader;
+		array<String^>^ _destinations;
+
+	public:
+		EntryExtractor(MBundleReader^ reader, array<String^>^ destinations)
+			: _reader(reader), _destinations(destinations)
+		{
+		}
+
+		void Run(int index)
+		{
+			_reader->Extract(_reader->Entries[index], _destinations[index]);
+		}
+	};
+
+}
+
+#pragma region MBundleWriter
+
+MBundleWriter::MBundleWriter()
+	: _projects(gcnew List<IOvlProject^>()), _outputs(gcnew List<MOvlOutputs>()), _targets(gcnew List<MBuildTargets^>())
+{
+	ChunkSize = 1024 * 1024;
+	Level = CompressionLevel::Optimal;
+	BatchSize = 256;
+}
+
+void MBundleWriter::Add(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets)
+{
+	_projects->Add(project);
+	_outputs->Add(outputs);
+	_targets->Add(targets);
+}
+
+bool MBundleWriter::Write(String^ bundleFile, MOutputLog^ log)
+{
+	unsigned int errors = log->GetErrorCount();
+	String^ scratch = Path::Combine(Path::GetTempPath(), "bundle-" + Guid::NewGuid().ToString("N"));
+
+	List<String^>^ names = gcnew List<String^>();
+	List<String^>^ sources = gcnew List<String^>();
+	Dictionary<String^, String^>^ entries = gcnew Dictionary<String^, String^>(StringComparer::OrdinalIgnoreCase);
+
+	try
+	{
+		for (int p = 0; p < _projects->Count; p++)
+		{
+			MBuildTargets^ targets = _targets[p];
+			MBuildTargets^ staged = gcnew MBuildTargets();
+			String^ directory = Path::Combine(scratch, p.ToString());
+
+			MOvlOutputs generated = _outputs[p] & ~MOvlOutputs::Models;
+
+			for (int bit = 1; bit < static_cast<int>(MOvlOutputs::Models); bit <<= 1)
+			{
+				MOvlOutputs output = static_cast<MOvlOutputs>(bit);
+
+				if ((generated & output) == MOvlOutputs::None)
+					continue;
+
+				String^ target = Path::Combine(directory, targets->Get(output));
+				Directory::CreateDirectory(Path::GetDirectoryName(target));
+				staged->Set(output, target);
+			}
+
+			_projects[p]->Build(generated, staged, log);
+
+			if (log->GetErrorCount() != errors)
+				return false;
+
+			for (int bit = 1; bit < static_cast<int>(MOvlOutputs::Models); bit <<= 1)
+			{
+				MOvlOutputs output = static_cast<MOvlOutputs>(bit);
+
+				if ((generated & output) == MOvlOutputs::None)
+					continue;
+
+				String^ relative = Path::GetDirectoryName(targets->Get(output));
+
+				for each (String^ file in util::GetSavedOvlFiles(staged->Get(output)))
+				{
+					if (!AddEntry(Path::Combine(relative, Path::GetFileName(file)), file, names, sources, entries, log))
+						return false;
+				}
+			}
+
+			// Projects sharing models only store them once
+			if ((_outputs[p] & MOvlOutputs::Models) != MOvlOutputs::None)
+			{
+				for each (String^ file in _projects[p]->GetInputs(MOvlOutputs::Models))
+				{
+					if (String::IsNullOrWhiteSpace(file))
+						continue;
+
+					if (!AddEntry(Path::Combine(targets->ModelDirectory, Path::GetFileName(file)), file, names, sources, entries, log))
+						return false;
+				}
+			}
+		}
+
+		WriteBundle(bundleFile, names, sources);
+	}
+	finally
+	{
+		if (Directory::Exists(scratch))
+			Directory::Delete(scratch, true);
+	}
+
+	log->Info(String::Format("Bundle: {0} files from {1} projects written to {2}.", names->Count, _projects->Count, bundleFile));
+
+	return true;
+}
+
+bool MBundleWriter::AddEntry(String^ name, String^ source, List<String^>^ names, List<String^>^ sources,
+	Dictionary<String^, String^>^ entries, MOutputLog^ log)
+{
+	name = name->Replace(Path::AltDirectorySeparatorChar, Path::DirectorySeparatorChar);
+	source = Path::GetFullPath(source);
+
+	String^ existing;
+
+	if (entries->TryGetValue(name, existing))
+	{
+		if (String::Equals(existing, source, StringComparison::OrdinalIgnoreCase))
+			return true;
+
+		log->Error(String::Format("Bundle: \"{0}\" and \"{1}\" would both be stored as \"{2}\", give the projects different targets.",
+			existing, source, name));
+		return false;
+	}
+
+	entries->Add(name, source);
+	names->Add(name);
+	sources->Add(source);
+
+	return true;
+}
+
+void MBundleWriter::WriteBundle(String^ bundleFile, List<String^>^ names, List<String^>^ sources)
+{
+	// Contents hashes for the index, every file in parallel
+	std::vector<std::vector<std::string>> groups;
+
+	for each (String^ source in sources)
+		groups.push_back(std::vector<std::string>(1, util::std_string(source)));
+
+	std::vector<unsigned long long> hashes;
+	std::vector<std::string> hashErrors;
+
+	HashFiles(groups, hashes, hashErrors);
+
+	for (size_t i = 0; i < hashErrors.size(); i++)
+	{
+		if (!hashErrors[i].empty())
+			throw gcnew IOException(marshal_as<String^>(hashErrors[i]));
+	}
+
+	// Every chunk of every file, in file order
+	List<int>^ chunkFiles = gcnew List<int>();
+	List<long long>^ chunkOffsets = gcnew List<long long>();
+	array<MBundleEntry^>^ entries = gcnew array<MBundleEntry^>(names->Count);
+
+	for (int i = 0; i < names->Count; i++)
+	{
+		entries[i] = gcnew MBundleEntry();
+		entries[i]->Name = names[i];
+		entries[i]->Size = (gcnew FileInfo(sources[i]))->Length;
+		entries[i]->Hash = hashes[i];
+		entries[i]->FirstChunk = chunkFiles->Count;
+
+		for (long long offset = 0; offset < entries[i]->Size; offset += ChunkSize)
+		{
+			chunkFiles->Add(i);
+			chunkOffsets->Add(offset);
+		}
+
+		entries[i]->ChunkCount = chunkFiles->Count - entries[i]->FirstChunk;
+	}
+
+	int chunks = chunkFiles->Count;
+	array<long long>^ offsets = gcnew array<long long>(chunks);
+	array<int>^ sizes = gcnew array<int>(chunks);
+	array<int>^ rawSizes = gcnew array<int>(chunks);
+
+	String^ temporary = bundleFile + ".tmp";
+	FileStream^ stream = gcnew FileStream(temporary, FileMode::Create, FileAccess::Write, FileShare::None, 1 << 16);
+
+	try
+	{
+		BinaryWriter^ writer = gcnew BinaryWriter(stream, Encoding::UTF8, true);
+
+		writer->Write(Magic);
+		writer->Write(Version);
+		writer->Write(ChunkSize);
+		writer->Write(names->Count);
+		writer->Write(0LL);  // Index offset, written last
+
+		// A batch of chunks is compressed in parallel, then appended in order
+		int batchSize = Math::Max(BatchSize, 1);
+
+		for (int first = 0; first < chunks; first += batchSize)
+		{
+			int count = Math::Min(batchSize, chunks - first);
+			ChunkCompressor^ compressor = gcnew ChunkCompressor(sources, Level, count);
+
+			for (int i = 0; i < count; i++)
+			{
+				MBundleEntry^ entry = entries[chunkFiles[first + i]];
+
+				compressor->Files[i] = chunkFiles[first + i];
+				compressor->Offsets[i] = chunkOffsets[first + i];
+				compressor->Lengths[i] = static_cast<int>(Math::Min(static_cast<long long>(ChunkSize), entry->Size - chunkOffsets[first + i]));
+			}
+
+			Parallel::For(0, count, gcnew Action<int>(compressor, &ChunkCompressor::Run));
+
+			for (int i = 0; i < count; i++)
+			{
+				offsets[first + i] = stream->Position;
+				sizes[first + i] = compressor->Results[i]->Length;
+				rawSizes[first + i] = compressor->Lengths[i];
+
+				stream->Write(compressor->Results[i], 0, compressor->Results[i]->Length);
+			}
+		}
+
+		long long indexOffset = stream->Position;
+
+		for each (MBundleEntry^ entry in entries)
+		{
+			writer->Write(entry->Name);
+			writer->Write(entry->Size);
+			writer->Write(entry->Hash);
+			writer->Write(entry->FirstChunk);
+			writer->Write(entry->ChunkCount);
+		}
+
+		writer->Write(chunks);
+
+		for (int i = 0; i < chunks; i++)
+		{
+			writer->Write(offsets[i]);
+			writer->Write(sizes[i]);
+			writer->Write(rawSizes[i]);
+		}
+
+		writer->Seek(16, SeekOrigin::Begin);
+		writer->Write(indexOffset);
+		writer->Flush();
+
+		delete writer;
+	}
+	catch (Exception^)
+	{
+		delete stream;
+		File::Delete(temporary);
+		throw;
+	}
+
+	delete stream;
+
+	if (File::Exists(bundleFile))
+		File::Delete(bundleFile);
+
+	File::Move(temporary, bundleFile);
+}
+
+#pragma endregion
+
+#pragma region MBundleReader
+
+String^ MBundleReader::InstallPath(String^ root, String^ name)
+{
+	if (String::IsNullOrEmpty(name) || Path::IsPathRooted(name) ||
+		Array::IndexOf<String^>(name->Split(gcnew array<wchar_t>{ '\\', '/' }), "..") >= 0)
+		throw gcnew InvalidDataException("Bundle entry is outside the game directory: " + name);
+
+	String^ destination = Path::GetFullPath(Path::Combine(root, name));
+
+	if (!destination->StartsWith(root, StringComparison::OrdinalIgnoreCase))
+		throw gcnew InvalidDataException("Bundle entry is outside the game directory: " + name);
+
+	return destination;
+}
+
+MBundleReader::MBundleReader(String^ bundleFile)
+	: _entries(gcnew List<MBundleEntry^>())
+{
+	_file = MemoryMappedFile::CreateFromFile(bundleFile, FileMode::Open, nullptr, 0, MemoryMappedFileAccess::Read);
+
+	try
+	{
+		MemoryMappedViewStream^ view = _file->CreateViewStream(0, 0, MemoryMappedFileAccess::Read);
+		BinaryReader^ reader = gcnew BinaryReader(view, Encoding::UTF8);
+
+		try
+		{
+			if (reader->ReadUInt32() != MBundleWriter::Magic || reader->ReadUInt32() != MBundleWriter::Version)
+				throw gcnew InvalidDataException("Not a bundle, or made by another version: " + bundleFile);
+
+			reader->ReadInt32();  // Chunk size, only the writer needs it
+			int count = reader->ReadInt32();
+			view->Seek(reader->ReadInt64(), SeekOrigin::Begin);
+
+			for (int i = 0; i < count; i++)
+			{
+				MBundleEntry^ entry = gcnew MBundleEntry();
+				entry->Name = reader->ReadString();
+				entry->Size = reader->ReadInt64();
+				entry->Hash = reader->ReadUInt64();
+				entry->FirstChunk = reader->ReadInt32();
+				entry->ChunkCount = reader->ReadInt32();
+				_entries->Add(entry);
+			}
+
+			int chunks = reader->ReadInt32();
+			_chunkOffsets = gcnew array<long long>(chunks);
+			_chunkSizes = gcnew array<int>(chunks);
+			_chunkRawSizes = gcnew array<int>(chunks);
+
+			for (int i = 0; i < chunks; i++)
+			{
+				_chunkOffsets[i] = reader->ReadInt64();
+				_chunkSizes[i] = reader->ReadInt32();
+				_chunkRawSizes[i] = reader->ReadInt32();
+			}
+		}
+		catch (EndOfStreamException^)
+		{
+			throw gcnew InvalidDataException("Bundle index is truncated: " + bundleFile);
+		}
+		finally
+		{
+			delete reader;
+		}
+	}
+	catch (Exception^)
+	{
+		delete _file;
+		throw;
+	}
+}
+
+MBundleReader::~MBundleReader()
+{
+	delete _file;
+}
+
+MBundleEntry^ MBundleReader::Find(String^ name)
+{
+	for each (MBundleEntry^ entry in _entries)
+	{
+		if (String::Equals(entry->Name, name, StringComparison::OrdinalIgnoreCase))
+			return entry;
+	}
+
+	return nullptr;
+}
+
+void MBundleReader::Extract(MBundleEntry^ entry, String^ destination)
+{
+	if (entry->FirstChunk < 0 || entry->ChunkCount < 0 ||
+		static_cast<long long>(entry->FirstChunk) + entry->ChunkCount > _chunkOffsets->LongLength)
+		throw gcnew InvalidDataException("Bundle index is corrupt for " + entry->Name);
+
+	ContentHasher hasher;
+	long long written = 0;
+	array<unsigned char>^ buffer = gcnew array<unsigned char>(64 * 1024);
+
+	FileStream^ output = gcnew FileStream(destination, FileMode::Create, FileAccess::Write, FileShare::None, 1 << 16);
+
+	try
+	{
+		for (int c = entry->FirstChunk; c < entry->FirstChunk + entry->ChunkCount; c++)
+		{
+			// Maps only this chunk's bytes
+			MemoryMappedViewStream^ view = _file->CreateViewStream(_chunkOffsets[c], _chunkSizes[c], MemoryMappedFileAccess::Read);
+			DeflateStream^ inflate = gcnew DeflateStream(view, CompressionMode::Decompress);
+
+			try
+			{
+				long long chunkBytes = 0;
+
+				for (int n; (n = inflate->Read(buffer, 0, buffer->Length)) > 0;)
+				{
+					pin_ptr<unsigned char> data = &buffer[0];
+					hasher.Update(static_cast<unsigned char*>(data), n);
+
+					output->Write(buffer, 0, n);
+					chunkBytes += n;
+				}
+
+				if (chunkBytes != _chunkRawSizes[c])
+					throw gcnew InvalidDataException("Bundle chunk is corrupt in " + entry->Name);
+
+				written += chunkBytes;
+			}
+			finally
+			{
+				delete inflate;
+				delete view;
+			}
+		}
+	}
+	finally
+	{
+		delete output;
+	}
+
+	if (written != entry->Size || hasher.Final() != entry->Hash)
+		throw gcnew InvalidDataException("Bundle contents do not match the index for " + entry->Name);
+}
+
+void MBundleReader::Install(String^ gameDirectory)
+{
+	MStagedInstall^ install = gcnew MStagedInstall();
+
+	try
+	{
+		// Staging is not thread safe, every path is staged up front
+		array<String^>^ destinations = gcnew array<String^>(_entries->Count);
+		String^ root = Path::GetFullPath(gameDirectory)->TrimEnd(Path::DirectorySeparatorChar) + Path::DirectorySeparatorChar;
+
+		for (int i = 0; i < _entries->Count; i++)
+			destinations[i] = install->Stage(InstallPath(root, _entries[i]->Name));
+
+		EntryExtractor^ extractor = gcnew EntryExtractor(this, destinations);
+		Parallel::For(0, _entries->Count, gcnew Action<int>(extractor, &EntryExtractor::Run));
+
+		install->Commit();
+	}
+	finally
+	{
+		delete install;
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,149 @@
+// MBundle.hpp
+// Compressed single-file archives of built path sets
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+
+using namespace System::IO::Compression;
+using namespace System::IO::MemoryMappedFiles;
+
+namespace R3ALInterop
+{
+
+	// A bundle holds the built and copied OVLs of many projects, named by
+	// their path relative to the game directory. Layout:
+	//
+	//     Header   "R3BN", version, chunk size, file count, index offset
+	//     Chunks   Each file split into ChunkSize pieces, each deflated on its own
+	//     Index    Per file: name, size, hash, first chunk and chunk count,
+	//              then per chunk: offset, compressed and raw size
+	//
+	// Chunks are independent, so they are compressed in parallel and any
+	// file can be read without touching the others.
+
+	// One file of a bundle.
+	public ref class MBundleEntry
+	{
+	public:
+		property String^ Name;  // Relative to the game directory, e.g. "Path\MyPath\MyPath_Flat.common.ovl"
+		property long long Size;
+
+	internal:
+		unsigned long long Hash;  // ContentHasher of the contents
+		int FirstChunk;
+		int ChunkCount;
+	};
+
+	// Builds projects straight into a bundle.
+	public ref class MBundleWriter
+	{
+	private:
+		List<IOvlProject^>^ _projects;
+		List<MOvlOutputs>^ _outputs;
+		List<MBuildTargets^>^ _targets;
+
+		// Adds `source` as entry `name`. The same file added twice is stored
+		// once (projects sharing models), a different file under a name
+		// already taken is an error.
+		//     * Registers errors to the MOutputLog, returns false
+		bool AddEntry(String^ name, String^ source, List<String^>^ names, List<String^>^ sources,
+			Dictionary<String^, String^>^ entries, MOutputLog^ log);
+
+		// Compresses `sources` into `bundleFile` as `names`.
+		void WriteBundle(String^ bundleFile, List<String^>^ names, List<String^>^ sources);
+
+	public:
+		literal unsigned int Magic = 0x4E423352;  // "R3BN"
+		literal unsigned int Version = 1;
+
+		property int ChunkSize;              // Bytes per chunk, 1 MiB by default
+		property CompressionLevel Level;     // Optimal by default
+		property int BatchSize;              // Chunks compressed at a time, bounds memory, 256 by default
+
+		// Constructor.
+		MBundleWriter();
+
+		// Adds a project. `targets` are relative to the game directory and
+		// should match the stub's references, e.g. "Path\<Name>\<Name>" for
+		// the stub and "Path\<Name>\" for the models.
+		void Add(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets);
+
+		// Builds every project and writes the bundle. Generated OVLs are
+		// saved to a temporary directory, as the OVL writer only writes
+		// files, and deleted once compressed. Models are read from where
+		// the projects point to and are never copied.
+		//     * Registers build errors, and different files that would be
+		//       stored under the same name, to the MOutputLog, returns false
+		//       and writes nothing on failure
+		//     * Throws System::Exception-inherited classes on I/O errors
+		bool Write(String^ bundleFile, MOutputLog^ log);
+
+	};
+
+	// Reads a bundle through a memory mapping.
+	public ref class MBundleReader
+	{
+	private:
+		MemoryMappedFile^ _file;
+		List<MBundleEntry^>^ _entries;
+		array<long long>^ _chunkOffsets;
+		array<int>^ _chunkSizes;     // Compressed
+		array<int>^ _chunkRawSizes;
+
+		// Returns where entry `name` goes below `root`, a full path ending in
+		// a directory separator.
+		//     * Throws System::IO::InvalidDataException if the name is rooted,
+		//       has a ".." part or resolves outside `root`
+		static String^ InstallPath(String^ root, String^ name);
+
+	public:
+
+		// Constructor, reads the index.
+		//     * Throws System::IO::InvalidDataException if the file is not a bundle
+		//     * Throws System::Exception-inherited classes on I/O errors
+		MBundleReader(String^ bundleFile);
+
+		// Dispose
+		~MBundleReader();
+
+		property IReadOnlyList<MBundleEntry^>^ Entries
+		{
+			IReadOnlyList<MBundleEntry^>^ get() { return _entries->AsReadOnly(); }
+		}
+
+		// Returns the entry named `name` (case insensitive), nullptr if there is none.
+		MBundleEntry^ Find(String^ name);
+
+		// Decompresses one file to `destination`, reading only its chunks.
+		//     * Throws System::IO::InvalidDataException if the entry's chunks
+		//       are not in the chunk table or the contents do not match the index
+		//     * Throws System::Exception-inherited classes on I/O errors
+		void Extract(MBundleEntry^ entry, String^ destination);
+
+		// Extracts every file below `gameDirectory` in parallel, through an
+		// MStagedInstall so the install is all or nothing. Nothing is written
+		// if any entry would end up outside `gameDirectory`.
+		//     * Throws System::IO::InvalidDataException for such entries
+		//     * Throws System::Exception-inherited classes
+		void Install(String^ gameDirectory);
+
+	};
+
+}
@@ -0,0 +1,267 @@
+// MGoldenVerifier.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MGoldenVerifier.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Diagnostics;
+
+namespace R3ALInterop
+{
+
+	// Samples the private memory of the process while a build runs.
+	ref class MemorySampler
+	{
+	private:
+		Process^ _process;
+		Threading::Timer^ _timer;
+		long long _start;
+		long long _peak;
+
+		void Sample(Object^)
+		{
+			Threading::Monitor::Enter(this);
+
+			try
+			{
+				_process->Refresh();
+				_peak = Math::Max(_peak, _process->PrivateMemorySize64);
+			}
+			finally
+			{
+				Threading::Monitor::Exit(this);
+			}
+		}
+
+	public:
+		MemorySampler()
+		{
+			GC::Collect();
+			GC::WaitForPendingFinalizers();
+
+			_process = Process::GetCurrentProcess();
+			_start = _process->PrivateMemorySize64;
+			_peak = _start;
+			_timer = gcnew Threading::Timer(gcnew Threading::TimerCallback(this, &MemorySampler::Sample), nullptr, 0, 5);
+		}
+
+		// Stops sampling, returns the peak above the starting level.
+		long long Stop()
+		{
+			delete _timer;
+			Sample(nullptr);
+
+			return _peak - _start;
+		}
+	};
+
+}
+
+#pragma region Private
+
+void MGoldenVerifier::Build(MGoldenCase^ golden, String^ directory, MGoldenResult^ result)
+{
+	MBuildTargets^ targets = gcnew MBuildTargets();
+	targets->TextureOVL = Path::Combine(directory, "texture");
+	targets->IconOVL = Path::Combine(directory, "icon");
+	targets->StubOVL = Path::Combine(directory, "stub");
+	targets->BlankOVL = Path::Combine(directory, "blank");
+	targets->ModelDirectory = Path::Combine(directory, "models") + Path::DirectorySeparatorChar;
+
+	Directory::CreateDirectory(targets->ModelDirectory);
+
+	MOutputLog^ log = gcnew MOutputLog();
+
+	try
+	{
+		MemorySampler^ memory = gcnew MemorySampler();
+		Stopwatch^ watch = Stopwatch::StartNew();
+
+		golden->Project->Build(golden->Outputs, targets, log);
+
+		result->Milliseconds = watch->Elapsed.TotalMilliseconds;
+		result->PeakBytes = memory->Stop();
+
+		if (log->GetErrorCount())
+			result->Failures->Add("Build failed: " + log->GetErrors());
+	}
+	finally
+	{
+		delete log;
+	}
+}
+
+SortedSet<String^>^ MGoldenVerifier::ListFiles(String^ directory)
+{
+	SortedSet<String^>^ files = gcnew SortedSet<String^>(StringComparer::OrdinalIgnoreCase);
+	String^ root = Path::GetFullPath(directory)->TrimEnd(Path::DirectorySeparatorChar) + Path::DirectorySeparatorChar;
+
+	for each (String^ file in Directory::EnumerateFiles(root, "*", SearchOption::AllDirectories))
+		files->Add(file->Substring(root->Length));
+
+	return files;
+}
+
+void MGoldenVerifier::Compare(String^ expectedDirectory, String^ producedDirectory, MGoldenResult^ result)
+{
+	SortedSet<String^>^ expected = ListFiles(expectedDirectory);
+	SortedSet<String^>^ produced = ListFiles(producedDirectory);
+
+	for each (String^ file in expected)
+	{
+		if (!produced->Contains(file))
+			result->Failures->Add("Missing output: " + file);
+		else if (!util::SameFileContents(Path::Combine(expectedDirectory, file), Path::Combine(producedDirectory, file)))
+			result->Failures->Add("Output differs: " + file);
+	}
+
+	for each (String^ file in produced)
+	{
+		if (!expected->Contains(file))
+			result->Failures->Add("Unexpected output: " + file);
+	}
+}
+
+#pragma endregion
+
+#pragma region Public
+
+MGoldenResult^ MGoldenVerifier::Verify(MGoldenCase^ golden, MGoldenThresholds^ thresholds)
+{
+	if (!Directory::Exists(golden->GoldenDirectory))
+		throw gcnew DirectoryNotFoundException("Golden directory not found: " + golden->GoldenDirectory);
+
+	MGoldenResult^ result = gcnew MGoldenResult();
+	result->Name = golden->Name;
+
+	String^ scratch = Path::Combine(Path::GetTempPath(), "golden-" + Guid::NewGuid().ToString("N"));
+
+	try
+	{
+		Build(golden, scratch, result);
+		Compare(golden->GoldenDirectory, scratch, result);
+	}
+	finally
+	{
+		if (Directory::Exists(scratch))
+			Directory::Delete(scratch, true);
+	}
+
+	if (golden->BaselineMilliseconds > 0 && result->Milliseconds > golden->BaselineMilliseconds * thresholds->Time)
+	{
+		result->Failures->Add(String::Format("Build time {0:F0} ms exceeds baseline {1:F0} ms by more than {2:P0}",
+			result->Milliseconds, golden->BaselineMilliseconds, thresholds->Time - 1.0));
+	}
+
+	if (golden->BaselinePeakBytes > 0 && result->PeakBytes > golden->BaselinePeakBytes * thresholds->Memory)
+	{
+		result->Failures->Add(String::Format("Peak memory {0:N0} bytes exceeds baseline {1:N0} bytes by more than {2:P0}",
+			result->PeakBytes, golden->BaselinePeakBytes, thresholds->Memory - 1.0));
+	}
+
+	return result;
+}
+
+List<MGoldenResult^>^ MGoldenVerifier::VerifyAll(IEnumerable<MGoldenCase^>^ cases, MGoldenThresholds^ thresholds)
+{
+	List<MGoldenResult^>^ results = gcnew List<MGoldenResult^>();
+
+	// One at a time, so the measurements do not disturb each other
+	for each (MGoldenCase^ golden in cases)
+		results->Add(Verify(golden, thresholds));
+
+	return results;
+}
+
+MGoldenResult^ MGoldenVerifier::Record(MGoldenCase^ golden)
+{
+	MGoldenResult^ result = gcnew MGoldenResult();
+	result->Name = golden->Name;
+
+	String^ scratch = golden->GoldenDirectory->TrimEnd(Path::DirectorySeparatorChar) + ".recording";
+
+	if (Directory::Exists(scratch))
+		Directory::Delete(scratch, true);
+
+	Build(golden, scratch, result);
+
+	if (!result->Passed)
+	{
+		Directory::Delete(scratch, true);
+		throw gcnew InvalidOperationException(result->Failures[0]);
+	}
+
+	if (Directory::Exists(golden->GoldenDirectory))
+		Directory::Delete(golden->GoldenDirectory, true);
+
+	Directory::Move(scratch, golden->GoldenDirectory);
+
+	return result;
+}
+
+MGoldenResult^ MGoldenVerifier::VerifyDeterministic(MGoldenCase^ golden)
+{
+	MGoldenResult^ result = gcnew MGoldenResult();
+	result->Name = golden->Name;
+
+	if (!golden->Project->IsDeterministic(golden->Outputs))
+	{
+		result->Failures->Add("Project is not deterministic for " + golden->Outputs.ToString());
+		return result;
+	}
+
+	String^ first = Path::Combine(Path::GetTempPath(), "golden-" + Guid::NewGuid().ToString("N"));
+	String^ second = Path::Combine(Path::GetTempPath(), "golden-" + Guid::NewGuid().ToString("N"));
+
+	try
+	{
+		Build(golden, first, result);
+
+		if (result->Passed)
+			Build(golden, second, result);
+
+		if (result->Passed)
+			Compare(first, second, result);
+	}
+	finally
+	{
+		if (Directory::Exists(first))
+			Directory::Delete(first, true);
+
+		if (Directory::Exists(second))
+			Directory::Delete(second, true);
+	}
+
+	return result;
+}
+
+String^ MGoldenVerifier::Report(IEnumerable<MGoldenResult^>^ results)
+{
+	StringBuilder^ report = gcnew StringBuilder();
+
+	for each (MGoldenResult^ result in results)
+	{
+		report->AppendFormat("{0} {1}: {2:F0} ms, {3:N0} bytes peak", result->Passed ? "PASS" : "FAIL",
+			result->Name, result->Milliseconds, result->PeakBytes)->AppendLine();
+
+		for each (String^ failure in result->Failures)
+			report->Append("    ")->AppendLine(failure);
+	}
+
+	return report->ToString();
+}
+
+#pragma endregion
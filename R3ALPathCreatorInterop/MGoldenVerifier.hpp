@@ -0,0 +1,129 @@
+// MGoldenVerifier.hpp
+// Checks project builds against reference OVL outputs and performance baselines
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+
+namespace R3ALInterop
+{
+
+	// One reference project and the outputs it must reproduce.
+	public ref class MGoldenCase
+	{
+	public:
+		property String^ Name;
+		property IOvlProject^ Project;
+		property MOvlOutputs Outputs;
+
+		// Holds the expected files, laid out as MGoldenVerifier builds them:
+		// texture, icon, stub and blank OVLs, and models\ for the model OVLs.
+		property String^ GoldenDirectory;
+
+		property double BaselineMilliseconds;  // 0 = not checked
+		property long long BaselinePeakBytes;  // 0 = not checked
+
+		// Constructor.
+		MGoldenCase()
+		{
+			Name = "";
+			Outputs = MOvlOutputs::All;
+			GoldenDirectory = "";
+		}
+	};
+
+	// How far a case may exceed its baselines, as a ratio.
+	public ref class MGoldenThresholds
+	{
+	public:
+		property double Time;    // 1.25 by default
+		property double Memory;  // 1.25 by default
+
+		// Constructor.
+		MGoldenThresholds()
+		{
+			Time = 1.25;
+			Memory = 1.25;
+		}
+	};
+
+	// Outcome of one case.
+	public ref class MGoldenResult
+	{
+	public:
+		property String^ Name;
+		property List<String^>^ Failures;  // Empty when the case passed
+		property double Milliseconds;
+		property long long PeakBytes;      // Private memory above the level before the build
+
+		property bool Passed
+		{
+			bool get() { return Failures->Count == 0; }
+		}
+
+		// Constructor.
+		MGoldenResult()
+		{
+			Name = "";
+			Failures = gcnew List<String^>();
+		}
+	};
+
+	// Builds reference projects into a scratch directory and byte-compares
+	// every file produced with the golden outputs, so changes to texture or
+	// OVL generation cannot alter the shipped files unnoticed. Build time and
+	// peak memory are compared with the case baselines.
+	public ref class MGoldenVerifier
+	{
+	private:
+
+		// Builds `golden` into `directory`, filling the measurements of `result`.
+		static void Build(MGoldenCase^ golden, String^ directory, MGoldenResult^ result);
+
+		// Returns the files below `directory`, relative to it.
+		static SortedSet<String^>^ ListFiles(String^ directory);
+
+		// Adds a failure for each file missing, extra or different in `producedDirectory`.
+		static void Compare(String^ expectedDirectory, String^ producedDirectory, MGoldenResult^ result);
+
+	public:
+
+		// Builds one case and compares it.
+		//     * Throws System::Exception-inherited classes if the golden
+		//       directory does not exist
+		static MGoldenResult^ Verify(MGoldenCase^ golden, MGoldenThresholds^ thresholds);
+
+		static List<MGoldenResult^>^ VerifyAll(IEnumerable<MGoldenCase^>^ cases, MGoldenThresholds^ thresholds);
+
+		// Builds one case twice and compares the two builds byte for byte, as
+		// MOutputCache relies on. Needs no golden outputs. The measurements
+		// are those of the last build.
+		static MGoldenResult^ VerifyDeterministic(MGoldenCase^ golden);
+
+		// Builds one case and replaces its golden outputs with the result. The
+		// measurements are returned so they can be kept as the new baselines.
+		//     * Throws System::Exception-inherited classes
+		static MGoldenResult^ Record(MGoldenCase^ golden);
+
+		// Returns one line per case, followed by the failures.
+		static String^ Report(IEnumerable<MGoldenResult^>^ results);
+
+	};
+
+}
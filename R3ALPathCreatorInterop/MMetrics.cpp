@@ -0,0 +1,92 @@
+// MMetrics.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MMetrics.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Globalization;
+
+MMetrics::MMetrics()
+{
+	Counters = gcnew Dictionary<String^, long long>();
+	Stages = gcnew Dictionary<String^, MHistogram^>();
+}
+
+MMetrics::MMetrics(const MetricsSnapshot& snapshot)
+{
+	Counters = gcnew Dictionary<String^, long long>();
+	Stages = gcnew Dictionary<String^, MHistogram^>();
+
+	for (size_t i = 0; i < static_cast<size_t>(Counter::Count); i++)
+		Counters[gcnew String(CounterName(static_cast<Counter>(i)))] = snapshot.Counters[i];
+
+	for (size_t i = 0; i < static_cast<size_t>(Stage::Count); i++)
+	{
+		const HistogramSnapshot& stage = snapshot.Stages[i];
+
+		MHistogram^ histogram = gcnew MHistogram();
+		histogram->Count = stage.Count;
+		histogram->Sum = stage.Sum;
+		histogram->Min = stage.Min;
+		histogram->Max = stage.Max;
+		histogram->Buckets = gcnew array<long long>(HistogramBuckets);
+
+		for (unsigned int b = 0; b < HistogramBuckets; b++)
+			histogram->Buckets[b] = stage.Buckets[b];
+
+		Stages[gcnew String(StageName(static_cast<Stage>(i)))] = histogram;
+	}
+}
+
+String^ MMetrics::ToJson()
+{
+	// Names are plain identifiers, nothing needs escaping
+	CultureInfo^ invariant = CultureInfo::InvariantCulture;
+	StringBuilder^ json = gcnew StringBuilder();
+
+	json->Append("{\n  \"counters\": {");
+
+	bool first = true;
+
+	for each (KeyValuePair<String^, long long> counter in Counters)
+	{
+		json->Append(first ? "\n" : ",\n");
+		json->AppendFormat(invariant, "    \"{0}\": {1}", counter.Key, counter.Value);
+		first = false;
+	}
+
+	json->Append("\n  },\n  \"stages\": {");
+	first = true;
+
+	for each (KeyValuePair<String^, MHistogram^> stage in Stages)
+	{
+		MHistogram^ histogram = stage.Value;
+
+		json->Append(first ? "\n" : ",\n");
+		json->AppendFormat(invariant, "    \"{0}\": {{ \"count\": {1}, \"sumMs\": {2:R}, \"minMs\": {3:R}, \"maxMs\": {4:R}, \"meanMs\": {5:R}, \"bucketsLog2Us\": [",
+			stage.Key, histogram->Count, histogram->Sum, histogram->Min, histogram->Max, histogram->Mean);
+
+		for (int b = 0; b < histogram->Buckets->Length; b++)
+			json->Append(b ? ", " : "")->Append(histogram->Buckets[b]);
+
+		json->Append("] }");
+		first = false;
+	}
+
+	json->Append("\n  }\n}\n");
+
+	return json->ToString();
+}
@@ -0,0 +1,63 @@
+// MMetrics.hpp
+// Managed snapshot of the build metrics collected by an MOutputLog
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "Metrics.hpp"
+
+namespace R3ALInterop
+{
+
+	// Latency histogram of one pipeline stage, in milliseconds.
+	public ref class MHistogram
+	{
+	public:
+		property long long Count;
+		property double Sum;
+		property double Min;
+		property double Max;
+
+		property double Mean
+		{
+			double get() { return Count ? Sum / Count : 0.0; }
+		}
+
+		// Bucket i counts samples below 2^i microseconds, the last one the rest.
+		property array<long long>^ Buckets;
+	};
+
+	// Counters and stage histograms, keyed by their camelCase names.
+	public ref class MMetrics
+	{
+	public:
+		property Dictionary<String^, long long>^ Counters;
+		property Dictionary<String^, MHistogram^>^ Stages;
+
+		// Constructor.
+		MMetrics();
+
+		// Returns the metrics as a JSON object.
+		String^ ToJson();
+
+	internal:
+
+		MMetrics(const MetricsSnapshot& snapshot);
+
+	};
+
+}
@@ -0,0 +1,384 @@
+// MOutputCache.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MOutputCache.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Globalization;
+using namespace System::Reflection;
+using namespace System::Security::Cryptography;
+
+namespace R3ALInterop
+{
+
+	// Orders properties by name, so the description does not depend on
+	// reflection order.
+	ref class PropertyNameComparer : IComparer<PropertyInfo^>
+	{
+	public:
+		virtual int Compare(PropertyInfo^ a, PropertyInfo^ b)
+		{
+			return String::CompareOrdinal(a->Name, b->Name);
+		}
+	};
+
+}
+
+#pragma region Private
+
+String^ MOutputCache::HexOf(array<unsigned char>^ digest)
+{
+	return BitConverter::ToString(digest)->Replace("-", "")->ToLowerInvariant();
+}
+
+String^ MOutputCache::DigestFile(String^ file)
+{
+	try
+	{
+		FileStream^ stream = File::OpenRead(file);
+		SHA256^ sha = SHA256::Create();
+
+		try
+		{
+			return String::Format("{0} {1}", stream->Length, HexOf(sha->ComputeHash(stream)));
+		}
+		finally
+		{
+			delete stream;
+			delete sha;
+		}
+	}
+	catch (IOException^)
+	{
+		return nullptr;
+	}
+	catch (UnauthorizedAccessException^)
+	{
+		return nullptr;
+	}
+}
+
+String^ MOutputCache::LibraryDigest()
+{
+	if (_libraryDigest == nullptr)
+		_libraryDigest = DigestFile(Assembly::GetExecutingAssembly()->Location);
+
+	return _libraryDigest;
+}
+
+void MOutputCache::Describe(Object^ value, StringBuilder^ text)
+{
+	if (value == nullptr)
+	{
+		text->Append("null");
+		return;
+	}
+
+	String^ str = dynamic_cast<String^>(value);
+
+	if (str != nullptr)
+	{
+		// Both spellings of a path give the same outputs
+		try
+		{
+			if (Path::IsPathRooted(str))
+				str = Path::GetFullPath(str)->ToLowerInvariant();
+		}
+		catch (ArgumentException^)
+		{
+		}
+		catch (NotSupportedException^)
+		{
+		}
+
+		text->AppendFormat("{0}:{1}", str->Length, str);
+		return;
+	}
+
+	Type^ type = value->GetType();
+
+	if (type->IsEnum || type->IsPrimitive)
+	{
+		// Round-trippable, so close floating point values do not share a key
+		if (type == double::typeid || type == float::typeid)
+			text->Append(safe_cast<IFormattable^>(value)->ToString("R", CultureInfo::InvariantCulture));
+		else
+			text->Append(Convert::ToString(value, CultureInfo::InvariantCulture));
+
+		return;
+	}
+
+	IDictionary^ dictionary = dynamic_cast<IDictionary^>(value);
+
+	if (dictionary != nullptr)
+	{
+		List<String^>^ entries = gcnew List<String^>();
+
+		for each (DictionaryEntry entry in dictionary)
+		{
+			StringBuilder^ item = gcnew StringBuilder();
+			Describe(entry.Key, item);
+			item->Append("=");
+			Describe(entry.Value, item);
+			entries->Add(item->ToString());
+		}
+
+		entries->Sort(StringComparer::Ordinal);
+		text->Append("{")->Append(String::Join(";", entries))->Append("}");
+		return;
+	}
+
+	IEnumerable^ list = dynamic_cast<IEnumerable^>(value);
+
+	if (list != nullptr)
+	{
+		text->Append("[");
+
+		for each (Object^ item in list)
+		{
+			Describe(item, text);
+			text->Append(";");
+		}
+
+		text->Append("]");
+		return;
+	}
+
+	// Structures such as MPathSection
+	array<PropertyInfo^>^ properties = type->GetProperties(BindingFlags::Public | BindingFlags::Instance);
+	Array::Sort(properties, gcnew PropertyNameComparer());
+
+	text->Append("(");
+
+	for each (PropertyInfo^ property in properties)
+	{
+		if (!property->CanRead || property->GetIndexParameters()->Length)
+			continue;
+
+		text->Append(property->Name)->Append("=");
+		Describe(property->GetValue(value), text);
+		text->Append(";");
+	}
+
+	text->Append(")");
+}
+
+String^ MOutputCache::DescribeBuild(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets)
+{
+	if (LibraryDigest() == nullptr)
+		return nullptr;
+
+	StringBuilder^ text = gcnew StringBuilder();
+
+	text->AppendFormat("library {0}\n", LibraryDigest());
+	text->AppendFormat("project {0}\n", project->GetType()->FullName);
+	text->AppendFormat("outputs {0}\n", outputs);
+
+	for (int bit = 1; bit < static_cast<int>(MOvlOutputs::Models); bit <<= 1)
+	{
+		MOvlOutputs output = static_cast<MOvlOutputs>(bit);
+
+		if ((outputs & output) != MOvlOutputs::None)
+			text->AppendFormat("target {0} {1}\n", output, Path::GetFileName(targets->Get(output))->ToLowerInvariant());
+	}
+
+	array<PropertyInfo^>^ properties = project->GetType()->GetProperties(BindingFlags::Public | BindingFlags::Instance);
+	Array::Sort(properties, gcnew PropertyNameComparer());
+
+	for each (PropertyInfo^ property in properties)
+	{
+		if (!property->CanRead || property->GetIndexParameters()->Length)
+			continue;
+
+		text->Append(property->Name)->Append("=");
+		Describe(property->GetValue(project), text);
+		text->Append("\n");
+	}
+
+	for each (String^ input in project->GetInputs(outputs))
+	{
+		if (String::IsNullOrWhiteSpace(input))
+			return nullptr;
+
+		String^ digest = DigestFile(input);
+
+		if (digest == nullptr)
+			return nullptr;
+
+		text->AppendFormat("input {0} {1}\n", Path::GetFullPath(input)->ToLowerInvariant(), digest);
+	}
+
+	return text->ToString();
+}
+
+String^ MOutputCache::ScratchTarget(String^ scratch, MOvlOutputs output, String^ target)
+{
+	String^ directory = Path::Combine(scratch, output.ToString());
+	Directory::CreateDirectory(directory);
+
+	return Path::Combine(directory, Path::GetFileName(target));
+}
+
+void MOutputCache::CopyOutput(String^ target, String^ directory)
+{
+	for each (String^ file in util::GetSavedOvlFiles(target))
+		File::Copy(file, Path::Combine(directory, Path::GetFileName(file)), true);
+}
+
+String^ MOutputCache::KeyOf(String^ description)
+{
+	SHA256^ sha = SHA256::Create();
+
+	try
+	{
+		return HexOf(sha->ComputeHash(Encoding::UTF8->GetBytes(description)));
+	}
+	finally
+	{
+		delete sha;
+	}
+}
+
+#pragma endregion
+
+#pragma region Public
+
+MOutputCache::MOutputCache(String^ directory)
+{
+	CacheDirectory = directory;
+}
+
+String^ MOutputCache::ComputeKey(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets)
+{
+	String^ description = DescribeBuild(project, outputs & CachedOutputs, targets);
+
+	return description != nullptr ? KeyOf(description) : nullptr;
+}
+
+void MOutputCache::Build(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log)
+{
+	MOvlOutputs generated = outputs & CachedOutputs;
+	MOvlOutputs models = outputs & MOvlOutputs::Models;
+
+	if (generated == MOvlOutputs::None)
+	{
+		project->Build(outputs, targets, log);
+		return;
+	}
+
+	String^ description = project->IsDeterministic(generated) ? DescribeBuild(project, generated, targets) : nullptr;
+
+	// Not deterministic, or an input is missing and the build will say so
+	if (description == nullptr)
+	{
+		Bypassed++;
+		log->Info("Output cache: build cannot be cached, building as usual.");
+		project->Build(outputs, targets, log);
+		return;
+	}
+
+	String^ key = KeyOf(description);
+	String^ entry = Path::Combine(CacheDirectory, key);
+	String^ descriptionFile = Path::Combine(entry, DescriptionFile);
+
+	if (File::Exists(descriptionFile) && String::Equals(File::ReadAllText(descriptionFile, Encoding::UTF8), description))
+	{
+		for (int bit = 1; bit < static_cast<int>(MOvlOutputs::Models); bit <<= 1)
+		{
+			MOvlOutputs output = static_cast<MOvlOutputs>(bit);
+
+			if ((generated & output) != MOvlOutputs::None)
+			{
+				String^ target = targets->Get(output);
+				CopyOutput(Path::Combine(entry, output.ToString(), Path::GetFileName(target)), Path::GetDirectoryName(target));
+			}
+		}
+
+		Hits++;
+		log->Info(String::Format("Output cache: restored {0} from {1}.", generated, key));
+	}
+	else
+	{
+		unsigned int errors = log->GetErrorCount();
+		String^ scratch = Path::Combine(CacheDirectory, key + ".tmp-" + Guid::NewGuid().ToString("N"));
+
+		MBuildTargets^ staged = gcnew MBuildTargets();
+
+		for (int bit = 1; bit < static_cast<int>(MOvlOutputs::Models); bit <<= 1)
+		{
+			MOvlOutputs output = static_cast<MOvlOutputs>(bit);
+
+			if ((generated & output) == MOvlOutputs::None)
+				continue;
+
+			staged->Set(output, ScratchTarget(scratch, output, targets->Get(output)));
+		}
+
+		try
+		{
+			project->Build(generated, staged, log);
+
+			if (log->GetErrorCount() != errors)
+				return;
+
+			Misses++;
+
+			for (int bit = 1; bit < static_cast<int>(MOvlOutputs::Models); bit <<= 1)
+			{
+				MOvlOutputs output = static_cast<MOvlOutputs>(bit);
+
+				if ((generated & output) != MOvlOutputs::None)
+					CopyOutput(staged->Get(output), Path::GetDirectoryName(targets->Get(output)));
+			}
+
+			// The description goes in last and the entry appears in one move,
+			// so an entry with a description is always complete
+			try
+			{
+				File::WriteAllText(Path::Combine(scratch, DescriptionFile), description, Encoding::UTF8);
+
+				if (Directory::Exists(entry) && !File::Exists(descriptionFile))
+					Directory::Delete(entry, true);
+
+				if (!Directory::Exists(entry))
+					Directory::Move(scratch, entry);
+			}
+			catch (IOException^ e)
+			{
+				log->Warning(String::Format("Output cache: could not store {0}: {1}", key, e->Message));
+			}
+		}
+		finally
+		{
+			if (Directory::Exists(scratch))
+				Directory::Delete(scratch, true);
+		}
+	}
+
+	if (models != MOvlOutputs::None)
+		project->Build(models, targets, log);
+}
+
+void MOutputCache::Clear()
+{
+	if (!Directory::Exists(CacheDirectory))
+		return;
+
+	for each (String^ entry in Directory::GetDirectories(CacheDirectory))
+		Directory::Delete(entry, true);
+}
+
+#pragma endregion
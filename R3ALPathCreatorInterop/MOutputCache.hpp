@@ -0,0 +1,99 @@
+// MOutputCache.hpp
+// Reuses the generated OVLs of projects whose inputs have not changed
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+
+namespace R3ALInterop
+{
+
+	// Keeps the texture, icon, stub and blank OVLs of each build in
+	// "<CacheDirectory>\<key>\", where the key is the SHA-256 of everything
+	// the outputs are made from:
+	//
+	//     * Every public property of the project, in name order, with rooted
+	//       paths made full and lower case
+	//     * The size and SHA-256 of each input file (IOvlProject::GetInputs)
+	//     * The file names of the targets, which OVLs refer to themselves by
+	//     * The library itself, so a new build of it starts a new cache
+	//
+	// A build whose key is cached copies the stored files instead, byte for
+	// byte. The full description the key was hashed from is stored with the
+	// entry and compared on every hit, so a hash collision is a miss. Model
+	// OVLs are always copied as usual. Projects that are not deterministic
+	// for the requested outputs are built without the cache.
+	public ref class MOutputCache
+	{
+	private:
+		static initonly String^ DescriptionFile = "inputs.txt";  // Written last, marks an entry as complete
+		static initonly MOvlOutputs CachedOutputs = MOvlOutputs::Texture | MOvlOutputs::Icon | MOvlOutputs::Stub | MOvlOutputs::Blank;
+
+		static String^ _libraryDigest;
+
+		// Returns a digest as lower case hex.
+		static String^ HexOf(array<unsigned char>^ digest);
+
+		// Returns "<size> <SHA-256>" of a file, nullptr if it cannot be read.
+		static String^ DigestFile(String^ file);
+
+		// Digest of the loaded library file, taken once.
+		static String^ LibraryDigest();
+
+		// Appends the canonical text form of a property value.
+		static void Describe(Object^ value, StringBuilder^ text);
+
+		// Returns the text the key is hashed from, nullptr if an input cannot be read.
+		static String^ DescribeBuild(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets);
+
+		// Hashes a description into a key.
+		static String^ KeyOf(String^ description);
+
+		// Returns where a single output is built when storing it in `scratch`.
+		static String^ ScratchTarget(String^ scratch, MOvlOutputs output, String^ target);
+
+		// Copies the files an output produced (the plain, common and unique
+		// OVL) next to `target` to `directory`.
+		static void CopyOutput(String^ target, String^ directory);
+
+	public:
+		property String^ CacheDirectory;
+
+		property int Hits;      // Builds restored from the cache
+		property int Misses;    // Builds not found in the cache
+		property int Bypassed;  // Builds that could not be cached
+
+		// Constructor.
+		MOutputCache(String^ directory);
+
+		// Returns the cache key of a build, nullptr if an input cannot be read.
+		String^ ComputeKey(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets);
+
+		// Builds `outputs` like IOvlProject::Build, restoring the generated
+		// OVLs from the cache when possible and storing them otherwise.
+		//     * Registers errors to the MOutputLog
+		//     * Models: throws System::Exception-inherited classes, see CopyFilesTo
+		void Build(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log);
+
+		// Deletes every entry.
+		void Clear();
+
+	};
+
+}
@@ -37,12 +37,19 @@ void NativeErrorCallbackHandler::OnError(RCT3Debugging::OutputLog& sender, std::
 #pragma region MOutputLog
 
 MOutputLog::MOutputLog() 
-	: _outputLogInternal(new RCT3Debugging::OutputLog()), _callbackHandler(new NativeErrorCallbackHandler(this))
+	: _outputLogInternal(new RCT3Debugging::OutputLog()), _callbackHandler(new NativeErrorCallbackHandler(this)),
+	_metrics(new std::shared_ptr<BuildMetrics>(std::make_shared<BuildMetrics>()))
 {
+	RegisterMetrics(*_outputLogInternal, *_metrics);
 }
 
 MOutputLog::~MOutputLog()
 {
+	if (_outputLogInternal)
+		UnregisterMetrics(*_outputLogInternal);
+
+	delete _metrics;
+	_metrics = nullptr;
 	delete _outputLogInternal;
 	_outputLogInternal = nullptr;
 	delete _callbackHandler;
@@ -86,6 +93,21 @@ void MOutputLog::SaveToFile(String^ fileName)
 	_outputLogInternal->SaveToFile(util::std_string(fileName));
 }
 
+MMetrics^ MOutputLog::GetMetrics()
+{
+	return gcnew MMetrics((*_metrics)->Snapshot());
+}
+
+MMetrics^ MOutputLog::ResetMetrics()
+{
+	return gcnew MMetrics((*_metrics)->SnapshotAndReset());
+}
+
+void MOutputLog::SaveMetricsToFile(String^ fileName)
+{
+	File::WriteAllText(fileName, GetMetrics()->ToJson());
+}
+
 unsigned int MOutputLog::GetErrorCount()
 {
 	return _outputLogInternal->ErrorCount();
@@ -21,6 +21,7 @@
 
 #include "System.hpp"
 #include "Utilities.hpp"
+#include "MMetrics.hpp"
 
 namespace R3ALInterop
 {
@@ -50,6 +51,7 @@ namespace R3ALInterop
 		RCT3Debugging::OutputLog* _outputLogInternal;
 		NativeErrorCallbackHandler* _callbackHandler;
 		OvlErrorEventHandler^ _managedHandler;
+		std::shared_ptr<BuildMetrics>* _metrics;  // Shared with native code that records into it
 
 	public:
 
@@ -82,6 +84,17 @@ namespace R3ALInterop
 		// Saves the OutputLog to the specified file.
 		void SaveToFile(String^ fileName);
 
+		// Returns the counters and stage timings recorded since construction
+		// or the last ResetMetrics call.
+		MMetrics^ GetMetrics();
+
+		// Returns the metrics and starts counting from zero again, for hosts
+		// that reuse one log across builds.
+		MMetrics^ ResetMetrics();
+
+		// Saves the metrics to the specified file as JSON.
+		void SaveMetricsToFile(String^ fileName);
+
 		// Returns the amount of errors.
 		unsigned int GetErrorCount();
 
@@ -18,29 +18,6 @@
 
 using namespace R3ALInterop;
 
-#pragma region Macros
-
-// I hate macros, but it really helps with readability in this case
-
-#define DO_SECTION(PTDSECTION) sid.Name(ptd.PTDSECTION[0]); \
-	sid.TxtName = text; \
-	sid.GsiIcon = ptd.GsiIcon; \
-	sid.OvlPath = ovlPath + ptd.PTDSECTION[0]; \
-	sid.Svds.push_back(ptd.PTDSECTION[0] + ":svd"); \
-	sidCol.Add(sid); \
-	sid.Svds.clear();
-
-#define DO_OPTIONAL_SECTION(OPTSECTION) if (ptd.OPTSECTION[0].length()) { \
-	sid.Name(ptd.OPTSECTION[0]); \
-	sid.TxtName = text; \
-	sid.GsiIcon = ptd.GsiIcon; \
-	sid.OvlPath = ovlPath + ptd.OPTSECTION[0]; \
-	sid.Svds.push_back(ptd.OPTSECTION[0] + ":svd"); \
-	sidCol.Add(sid); \
-	sid.Svds.clear(); } 
-
-#pragma endregion
-
 #pragma region MPathSection
 
 MPathSection::MPathSection(String^ fileName)
@@ -48,16 +25,12 @@ MPathSection::MPathSection(String^ fileName)
 	Section = fileName;
 }
 
-RCT3Asset::PathSection MPathSection::Convert()
+std::string MPathSection::ModelName()
 {
-	RCT3Asset::PathSection section;
-
-	if (!String::IsNullOrWhiteSpace(Section))
-		section = util::GetOvlName_std(Section);
-	else
-		section = "";
+	if (String::IsNullOrWhiteSpace(Section))
+		return "";
 
-	return section;
+	return util::GetOvlName_std(Section);
 }
 
 #pragma endregion
@@ -66,175 +39,176 @@ RCT3Asset::PathSection MPathSection::Convert()
 
 MPath::MPath()
 {
+	_sections = gcnew array<MPathSection>(static_cast<int>(PathSectionCount));
+
+	for (int i = 0; i < _sections->Length; i++)
+		_sections[i] = MPathSection("");
+
 	Name = "";
 	IngameName = "";
+	Profile = MBuildProfile::Release;
 	Icon = "";
 	TextureA = "";
 	TextureB = "";
 	Shared = "";
-	Flat = MPathSection("");
-	StraightA = MPathSection("");
-	StraightB = MPathSection("");
-	CornerA = MPathSection("");
-	CornerB = MPathSection("");
-	CornerC = MPathSection("");
-	CornerD = MPathSection("");
-	TurnU = MPathSection("");
-	TurnLA = MPathSection("");
-	TurnLB = MPathSection("");
-	TurnTA = MPathSection("");
-	TurnTB = MPathSection("");
-	TurnTC = MPathSection("");
-	TurnX = MPathSection("");
-	Slope = MPathSection("");
-	SlopeStraight = MPathSection("");
-	SlopeStraightL = MPathSection("");
-	SlopeStraightR = MPathSection("");
-	SlopeMid = MPathSection("");
 	UnderwaterSupport = false;
 	IsExtended = false;
 	Unknown01 = 0;
 	Unknown02 = 1;
-	FlatFC = MPathSection("");
-	SlopeFC = MPathSection("");
-	SlopeBC = MPathSection("");
-	SlopeTC = MPathSection("");
-	SlopeStraightFC = MPathSection("");
-	SlopeStraightBC = MPathSection("");
-	SlopeStraightTC = MPathSection("");
-	SlopeStraightLFC = MPathSection("");
-	SlopeStraightLBC = MPathSection("");
-	SlopeStraightLTC = MPathSection("");
-	SlopeStraightRFC = MPathSection("");
-	SlopeStraightRBC = MPathSection("");
-	SlopeStraightRTC = MPathSection("");
-	SlopeMidFC = MPathSection("");
-	SlopeMidBC = MPathSection("");
-	SlopeMidTC = MPathSection("");
-	Paving = MPathSection("");
+	_modelOvlPaths = gcnew Dictionary<String^, String^>(StringComparer::OrdinalIgnoreCase);
+}
+
+MPathSection MPath::GetSection(int index)
+{
+	return _sections[index];
+}
+
+void MPath::SetSection(int index, MPathSection section)
+{
+	_sections[index] = section;
 }
 
 void MPath::CopyFilesTo(String^ destination)
 {
-	util::CopyOvlFile(Flat.Section, destination);
-	util::CopyOvlFile(StraightA.Section, destination);
-	util::CopyOvlFile(StraightB.Section, destination);
-	util::CopyOvlFile(CornerA.Section, destination);
-	util::CopyOvlFile(CornerB.Section, destination);
-	util::CopyOvlFile(CornerC.Section, destination);
-	util::CopyOvlFile(CornerD.Section, destination);
-	util::CopyOvlFile(TurnU.Section, destination);
-	util::CopyOvlFile(TurnLA.Section, destination);
-	util::CopyOvlFile(TurnLB.Section, destination);
-	util::CopyOvlFile(TurnTA.Section, destination);
-	util::CopyOvlFile(TurnTB.Section, destination);
-	util::CopyOvlFile(TurnTC.Section, destination);
-	util::CopyOvlFile(TurnX.Section, destination);
-	util::CopyOvlFile(Slope.Section, destination);
-	util::CopyOvlFile(SlopeStraight.Section, destination);
-	util::CopyOvlFile(SlopeStraightL.Section, destination);
-	util::CopyOvlFile(SlopeStraightR.Section, destination);
-	util::CopyOvlFile(SlopeMid.Section, destination);
+	util::CopyOvlFiles(GetModelFiles(), destination);
+}
 
-	if (IsExtended)
+List<String^>^ MPath::GetSectionModels()
+{
+	List<String^>^ files = gcnew List<String^>();
+
+	// Extended sections are optional
+	for (int i = 0; i < _sections->Length; i++)
 	{
-		util::CopyOvlFileOptional(FlatFC.Section, destination);
-		util::CopyOvlFileOptional(SlopeFC.Section, destination);
-		util::CopyOvlFileOptional(SlopeBC.Section, destination);
-		util::CopyOvlFileOptional(SlopeTC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightFC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightBC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightTC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightLFC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightLBC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightLTC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightRFC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightRBC.Section, destination);
-		util::CopyOvlFileOptional(SlopeStraightRTC.Section, destination);
-		util::CopyOvlFileOptional(SlopeMidFC.Section, destination);
-		util::CopyOvlFileOptional(SlopeMidBC.Section, destination);
-		util::CopyOvlFileOptional(SlopeMidTC.Section, destination);
-		util::CopyOvlFileOptional(Paving.Section, destination);
+		String^ file = _sections[i].Section;
+
+		if (IsSectionUsed(PathSections[i], !String::IsNullOrWhiteSpace(file), IsExtended))
+			files->Add(file);
 	}
 
-	util::CopyOvlFileOptional(Shared, destination);
+	return files;
+}
+
+List<String^>^ MPath::GetModelFiles()
+{
+	List<String^>^ files = GetSectionModels();
+
+	if (!String::IsNullOrWhiteSpace(Shared))
+		files->Add(Shared);
+
+	return files;
 }
 
 void MPath::CreateTextureOVL(String^ path, MOutputLog^ log)
 {
-	RCT3Asset::OvlFile ovl(log->Native());
+	CreateTextureOVL(path, log, nullptr);
+}
 
+void MPath::CreateTextureOVL(String^ path, MOutputLog^ log, MBuildControl^ control)
+{
 	RCT3Asset::TextureStyle txs = RCT3Asset::TextureStyle::PathGround;
 
-	txs.AddTo(ovl);
-
-	RCT3Asset::TexImage imgA(log->Native());
-	imgA.FromFile(util::std_string(TextureA));
+	TextureBuilder builder(log->Native());
 
-	RCT3Asset::TextureMip mainAMip(imgA);
+	TextureOptions options;
+	options.Control = control != nullptr ? control->Native() : nullptr;
 
 	RCT3Asset::Texture mainA;
-	mainA.Name(util::std_string(Path::GetFileNameWithoutExtension(TextureA)));
-	mainA.TxsStyle = txs;
-	mainA.Mips.push_back(mainAMip);
-
-	RCT3Asset::TexImage imgB(log->Native());
-	imgB.FromFile(util::std_string(TextureB));
 
-	RCT3Asset::TextureMip mainBMip(imgB);
+	if (!builder.Build(util::std_string(TextureA), util::std_string(Path::GetFileNameWithoutExtension(TextureA)), txs, mainA, options))
+	{
+		// Build stops without an error when cancelled
+		MBuildControl::ThrowIfCancelled(control);
+		return;
+	}
 
 	RCT3Asset::Texture mainB;
-	mainB.Name(util::std_string(Path::GetFileNameWithoutExtension(TextureB)));
-	mainB.TxsStyle = txs;
-	mainB.Mips.push_back(mainBMip);
+
+	if (!builder.Build(util::std_string(TextureB), util::std_string(Path::GetFileNameWithoutExtension(TextureB)), txs, mainB, options))
+	{
+		// Build stops without an error when cancelled
+		MBuildControl::ThrowIfCancelled(control);
+		return;
+	}
+
+	MBuildControl::ThrowIfCancelled(control);
+
+	SaveTextureOVL(mainA, mainB, path, log);
+}
+
+void MPath::SaveTextureOVL(RCT3Asset::Texture& textureA, RCT3Asset::Texture& textureB, String^ path, MOutputLog^ log)
+{
+	RCT3Asset::OvlFile ovl(log->Native());
+
+	RCT3Asset::TextureStyle txs = RCT3Asset::TextureStyle::PathGround;
+
+	txs.AddTo(ovl);
 
 	// always create flic before textures
 	RCT3Asset::FlicManager flic;
-	flic.Add(mainA);
-	flic.Add(mainB);
+	flic.Add(textureA);
+	flic.Add(textureB);
 	flic.CreateAndAssign(ovl);
 
 	// now we can create textures
 	RCT3Asset::TextureCollection texCol;
-	texCol.Add(mainA);
-	texCol.Add(mainB);
+	texCol.Add(textureA);
+	texCol.Add(textureB);
 	texCol.AddTo(ovl);
 
-	ovl.Save(util::std_string(path));
+	util::SaveOvl(ovl, path, log->Native());
 }
 
 void MPath::CreateIconOVL(String^ path, MOutputLog^ log)
 {
-	RCT3Asset::OvlFile ovl(log->Native());
+	CreateIconOVL(path, log, nullptr);
+}
 
+void MPath::CreateIconOVL(String^ path, MOutputLog^ log, MBuildControl^ control)
+{
 	RCT3Asset::TextureStyle txs = RCT3Asset::TextureStyle::GUIIcon;
-	txs.AddTo(ovl);
 
-	RCT3Asset::TexImage imgIcon(log->Native());
-	imgIcon.FromFile(util::std_string(Icon));
-
-	RCT3Asset::TextureMip mainMip(imgIcon);
+	TextureBuilder builder(log->Native());
 
 	RCT3Asset::Texture tex;
-	tex.Name(util::std_string(Path::GetFileNameWithoutExtension(Icon)));
-	tex.TxsStyle = txs;
-	tex.Mips.push_back(mainMip);
+
+	TextureOptions options(IconSize, IconSize);
+	options.Control = control != nullptr ? control->Native() : nullptr;
+
+	if (!builder.Build(util::std_string(Icon), util::std_string(Path::GetFileNameWithoutExtension(Icon)), txs, tex, options))
+	{
+		// Build stops without an error when cancelled
+		MBuildControl::ThrowIfCancelled(control);
+		return;
+	}
+
+	MBuildControl::ThrowIfCancelled(control);
+
+	SaveIconOVL(tex, Name, path, log);
+}
+
+void MPath::SaveIconOVL(RCT3Asset::Texture& texture, String^ name, String^ path, MOutputLog^ log)
+{
+	RCT3Asset::OvlFile ovl(log->Native());
+
+	RCT3Asset::TextureStyle txs = RCT3Asset::TextureStyle::GUIIcon;
+	txs.AddTo(ovl);
 
 	RCT3Asset::GuiSkinItem gsiIcon;
-	gsiIcon.Name(util::std_string(Name + "_Icon"));
+	gsiIcon.Name(util::std_string(name + "_Icon"));
 
 	RCT3Asset::IconPosition pos;
 
 	pos.Top = 0;
 	pos.Left = 0;
-	pos.Right = 40;
-	pos.Bottom = 40;
+	pos.Right = IconSize;
+	pos.Bottom = IconSize;
 
 	gsiIcon.Position = pos;
-	gsiIcon.Texture = tex;
+	gsiIcon.Texture = texture;
 
 	RCT3Asset::FlicManager flic;
-	flic.Add(tex);
+	flic.Add(texture);
 	flic.CreateAndAssign(ovl);
 
 	RCT3Asset::GuiSkinItemCollection gsiCol;
@@ -242,13 +216,32 @@ void MPath::CreateIconOVL(String^ path, MOutputLog^ log)
 	gsiCol.AddTo(ovl);
 
 	RCT3Asset::TextureCollection texCol;
-	texCol.Add(tex);
+	texCol.Add(texture);
 	texCol.AddTo(ovl);
 
-	ovl.Save(util::std_string(path));
+	util::SaveOvl(ovl, path, log->Native());
+}
+
+MPath^ MPath::CreateVariant(String^ name, String^ ingameName, String^ textureNameA, String^ textureNameB)
+{
+	MPath^ variant = safe_cast<MPath^>(MemberwiseClone());
+
+	variant->Name = name;
+	variant->IngameName = ingameName;
+	variant->_textureNameA = textureNameA;
+	variant->_textureNameB = textureNameB;
+	variant->_sections = safe_cast<array<MPathSection>^>(_sections->Clone());
+	variant->_modelOvlPaths = gcnew Dictionary<String^, String^>(_modelOvlPaths, StringComparer::OrdinalIgnoreCase);
+
+	return variant;
 }
 
 void MPath::CreateStubOVL(String^ path, MOutputLog^ log)
+{
+	CreateStubOVL(path, log, nullptr);
+}
+
+void MPath::CreateStubOVL(String^ path, MOutputLog^ log, MBuildControl^ control)
 {
 	RCT3Asset::OvlFile ovl(log->Native());
 
@@ -258,7 +251,7 @@ void MPath::CreateStubOVL(String^ path, MOutputLog^ log)
 
 	RCT3Asset::TextString text;
 	text.Name(util::std_string(Name + "_Text"));
-	text.Text(util::std_wstring(IngameName));
+	text.Text(util::std_wstring(ProfileSettings::IngameName(Profile, IngameName)));
 
 	RCT3Asset::TextStringCollection txtCol;
 	txtCol.Add(text);
@@ -274,51 +267,25 @@ void MPath::CreateStubOVL(String^ path, MOutputLog^ log)
 	if (UnderwaterSupport)
 		ptd.Flags |= RCT3Asset::PathFlags::Underwater;
 
-	ptd.TextureA = util::std_string(Path::GetFileNameWithoutExtension(TextureA));
-	ptd.TextureB = util::std_string(Path::GetFileNameWithoutExtension(TextureB));
-
-	ptd.Flat = Flat.Convert();
-	ptd.StraightA = StraightA.Convert();
-	ptd.StraightB = StraightB.Convert();
-	ptd.CornerA = CornerA.Convert();
-	ptd.CornerB = CornerB.Convert();
-	ptd.CornerC = CornerC.Convert();
-	ptd.CornerD = CornerD.Convert();
-	ptd.TurnU = TurnU.Convert();
-	ptd.TurnLA = TurnLA.Convert();
-	ptd.TurnLB = TurnLB.Convert();
-	ptd.TurnTA = TurnTA.Convert();
-	ptd.TurnTB = TurnTB.Convert();
-	ptd.TurnTC = TurnTC.Convert();
-	ptd.TurnX = TurnX.Convert();
-	ptd.Slope = Slope.Convert();
-	ptd.SlopeStraight = SlopeStraight.Convert();
-	ptd.SlopeStraightLeft = SlopeStraightL.Convert();
-	ptd.SlopeStraightRight = SlopeStraightR.Convert();
-	ptd.SlopeMid = SlopeMid.Convert();
+	ptd.TextureA = util::std_string(_textureNameA != nullptr ? _textureNameA : Path::GetFileNameWithoutExtension(TextureA));
+	ptd.TextureB = util::std_string(_textureNameB != nullptr ? _textureNameB : Path::GetFileNameWithoutExtension(TextureB));
+
+	std::vector<std::string> models(PathSectionCount);
+
+	for (size_t i = 0; i < PathSectionCount; i++)
+		models[i] = _sections[static_cast<int>(i)].ModelName();
+
+	// Paving is written as the file path it was set to, not as a model name
+	int paving = static_cast<int>(PathSectionId::Paving);
+	models[paving] = util::std_string(_sections[paving].Section);
+
+	SetPathSections(ptd, models, IsExtended);
 
 	if (IsExtended)
 	{
 		ptd.Flags |= RCT3Asset::PathFlags::Extended;
 		ptd.Unknown01 = Unknown01;
 		ptd.Unknown02 = Unknown02;
-		ptd.FlatFC = FlatFC.Convert();
-		ptd.SlopeFC = SlopeFC.Convert();
-		ptd.SlopeBC = SlopeBC.Convert();
-		ptd.SlopeTC = SlopeTC.Convert();
-		ptd.SlopeStraightFC = SlopeStraightFC.Convert();
-		ptd.SlopeStraightBC = SlopeStraightBC.Convert();
-		ptd.SlopeStraightTC = SlopeStraightTC.Convert();
-		ptd.SlopeStraightLeftFC = SlopeStraightLFC.Convert();
-		ptd.SlopeStraightLeftBC = SlopeStraightLBC.Convert();
-		ptd.SlopeStraightLeftTC = SlopeStraightLTC.Convert();
-		ptd.SlopeStraightRightFC = SlopeStraightRFC.Convert();
-		ptd.SlopeStraightRightBC = SlopeStraightRBC.Convert();
-		ptd.SlopeStraightRightTC = SlopeStraightRTC.Convert();
-		ptd.SlopeMidFC = SlopeMidFC.Convert();
-		ptd.SlopeMidBC = SlopeMidBC.Convert();
-		ptd.SlopeMidTC = SlopeMidTC.Convert();
-		ptd.Paving = util::std_string(Paving.Section);
 	}
 
 	RCT3Asset::PathCollection ptdCol;
@@ -334,71 +301,136 @@ void MPath::CreateStubOVL(String^ path, MOutputLog^ log)
 	sid.Size.Y = 3.0f;
 	sid.Size.Z = 4.0f;
 
-	DO_SECTION(Flat);
-	DO_SECTION(StraightA);
-	DO_SECTION(StraightB);
-	DO_SECTION(CornerA);
-	DO_SECTION(CornerB);
-	DO_SECTION(CornerC);
-	DO_SECTION(CornerD);
-	DO_SECTION(TurnU);
-	DO_SECTION(TurnLA);
-	DO_SECTION(TurnLB);
-	DO_SECTION(TurnTA);
-	DO_SECTION(TurnTB);
-	DO_SECTION(TurnTC);
-	DO_SECTION(TurnX);
-	DO_SECTION(Slope);
-	DO_SECTION(SlopeStraight);
-	DO_SECTION(SlopeStraightLeft);
-	DO_SECTION(SlopeStraightRight);
-	DO_SECTION(SlopeMid);
-
-	if (IsExtended)
+	for (size_t i = 0; i < PathSectionCount; i++)
 	{
-		DO_OPTIONAL_SECTION(FlatFC);
-		DO_OPTIONAL_SECTION(SlopeFC);
-		DO_OPTIONAL_SECTION(SlopeBC);
-		DO_OPTIONAL_SECTION(SlopeTC);
-		DO_OPTIONAL_SECTION(SlopeStraightFC);
-		DO_OPTIONAL_SECTION(SlopeStraightBC);
-		DO_OPTIONAL_SECTION(SlopeStraightTC);
-		DO_OPTIONAL_SECTION(SlopeStraightLeftFC);
-		DO_OPTIONAL_SECTION(SlopeStraightLeftBC);
-		DO_OPTIONAL_SECTION(SlopeStraightLeftTC);
-		DO_OPTIONAL_SECTION(SlopeStraightRightFC);
-		DO_OPTIONAL_SECTION(SlopeStraightRightBC);
-		DO_OPTIONAL_SECTION(SlopeStraightRightTC);
-		DO_OPTIONAL_SECTION(SlopeMidFC);
-		DO_OPTIONAL_SECTION(SlopeMidBC);
-		DO_OPTIONAL_SECTION(SlopeMidTC);
-
-		// Paving
-
-		if (ptd.Paving.length())
-		{
-			sid.Name(ptd.Paving);
-			sid.TxtName = text;
-			sid.GsiIcon = ptd.GsiIcon;
-			sid.OvlPath = ovlPath + ptd.Paving;
-			sid.Svds.push_back(ptd.Paving + ":svd");
-			sidCol.Add(sid);
-			sid.Svds.clear();
-		}
+		if (!IsSectionUsed(PathSections[i], !models[i].empty(), IsExtended))
+			continue;
+
+		sid.Name(models[i]);
+		sid.TxtName = text;
+		sid.GsiIcon = ptd.GsiIcon;
+		sid.OvlPath = util::ModelOvlPath(_modelOvlPaths, ovlPath, models[i]);
+		sid.Svds.push_back(models[i] + ":svd");
+		sidCol.Add(sid);
+		sid.Svds.clear();
 	}
 
 	ptdCol.AddTo(ovl);
 	sidCol.AddTo(ovl);
 	txtCol.AddTo(ovl);
 
-	ovl.Save(util::std_string(path));
+	MBuildControl::ThrowIfCancelled(control);
+
+	util::SaveOvl(ovl, path, log->Native());
 }
 
 void MPath::CreateBlankOVL(String^ path, MOutputLog^ log)
 {
 	RCT3Asset::OvlFile ovl(log->Native());
 
-	ovl.Save(util::std_string(path));
+	util::SaveOvl(ovl, path, log->Native());
+}
+
+void MPath::Run(MOvlOutputs output, String^ path, MOutputLog^ log, MBuildControl^ control)
+{
+	switch (output)
+	{
+	case MOvlOutputs::Texture:
+		CreateTextureOVL(path, log, control);
+		break;
+	case MOvlOutputs::Icon:
+		CreateIconOVL(path, log, control);
+		break;
+	case MOvlOutputs::Stub:
+		CreateStubOVL(path, log, control);
+		break;
+	case MOvlOutputs::Blank:
+		CreateBlankOVL(path, log);
+		break;
+	case MOvlOutputs::Models:
+		control->CopyOvlFiles(GetModelFiles(), path);
+		break;
+	default:
+		break;
+	}
+}
+
+Task^ MPath::CreateTextureOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MPath>(this, MOvlOutputs::Texture, path, log), progress, token);
+}
+
+Task^ MPath::CreateIconOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MPath>(this, MOvlOutputs::Icon, path, log), progress, token);
+}
+
+Task^ MPath::CreateStubOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MPath>(this, MOvlOutputs::Stub, path, log), progress, token);
+}
+
+Task^ MPath::CopyFilesToAsync(String^ destination, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MPath>(this, MOvlOutputs::Models, destination, nullptr), progress, token);
+}
+
+bool MPath::IsDeterministic(MOvlOutputs)
+{
+	return true;
+}
+
+List<String^>^ MPath::GetInputs(MOvlOutputs outputs)
+{
+	List<String^>^ inputs = gcnew List<String^>();
+
+	if ((outputs & MOvlOutputs::Texture) != MOvlOutputs::None)
+	{
+		inputs->Add(TextureA);
+		inputs->Add(TextureB);
+	}
+
+	if ((outputs & MOvlOutputs::Icon) != MOvlOutputs::None)
+		inputs->Add(Icon);
+
+	// Stub and blank OVLs only depend on properties
+	if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+	{
+		for each (String^ model in GetModelFiles())
+			util::AddOvlFiles(inputs, model);
+	}
+
+	return inputs;
+}
+
+void MPath::Build(MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log)
+{
+	if ((outputs & MOvlOutputs::Texture) != MOvlOutputs::None)
+		CreateTextureOVL(targets->TextureOVL, log);
+
+	if ((outputs & MOvlOutputs::Icon) != MOvlOutputs::None)
+		CreateIconOVL(targets->IconOVL, log);
+
+	if ((outputs & MOvlOutputs::Stub) != MOvlOutputs::None)
+		CreateStubOVL(targets->StubOVL, log);
+
+	if ((outputs & MOvlOutputs::Blank) != MOvlOutputs::None)
+		CreateBlankOVL(targets->BlankOVL, log);
+
+	if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+	{
+		if (ProfileSettings::CanReuseModels(this, targets->ModelDirectory))
+		{
+			log->Info("Draft build: model OVLs are already installed, not copying them.");
+		}
+		else
+		{
+			StageTimer timer(MetricsFor(log->Native()), Stage::Copy);
+
+			CopyFilesTo(targets->ModelDirectory);
+			util::RecordOvlCopies(GetModelFiles(), log->Native());
+		}
+	}
 }
 
 #pragma endregion
\ No newline at end of file
@@ -26,6 +26,10 @@
 #include "System.hpp"
 #include "Utilities.hpp"
 #include "MOutputLog.hpp"
+#include "TextureBuilder.hpp"
+#include "OvlProject.hpp"
+#include "MBuildTask.hpp"
+#include "SectionSchema.hpp"
 
 namespace R3ALInterop
 {
@@ -41,14 +45,28 @@ namespace R3ALInterop
 
 	internal:
 
-		// Converts this managed class to its unmanaged/native counterpart.
-		RCT3Asset::PathSection Convert();
+		// Returns the model name of the section, "" if it is not set.
+		std::string ModelName();
 
 	};
 
+	// Section property backed by MPath::_sections.
+	#define R3AL_SECTION_PROPERTY(PROPERTY, FIELD) \
+		property MPathSection PROPERTY \
+		{ \
+			MPathSection get() { return _sections[static_cast<int>(PathSectionId::PROPERTY)]; } \
+			void set(MPathSection value) { _sections[static_cast<int>(PathSectionId::PROPERTY)] = value; } \
+		}
+
 	// Managed wrapper class for RCT3Asset::Path class.
-	public ref class MPath
+	public ref class MPath : IOvlProject
 	{
+	private:
+		array<MPathSection>^ _sections;  // By PathSectionId
+		Dictionary<String^, String^>^ _modelOvlPaths;
+		String^ _textureNameA;  // Texture names written to the stub, null = the file names
+		String^ _textureNameB;
+
 	public:
 		property String^ Name;
 		property String^ IngameName;
@@ -56,56 +74,42 @@ namespace R3ALInterop
 		property String^ TextureA;
 		property String^ TextureB;
 		property String^ Shared; // Path to shared texture OVL, is not required for creating paths
-		property MPathSection Flat;
-		property MPathSection StraightA;
-		property MPathSection StraightB;
-		property MPathSection CornerA;
-		property MPathSection CornerB;
-		property MPathSection CornerC;
-		property MPathSection CornerD;
-		property MPathSection TurnU;
-		property MPathSection TurnLA;
-		property MPathSection TurnLB;
-		property MPathSection TurnTA;
-		property MPathSection TurnTB;
-		property MPathSection TurnTC;
-		property MPathSection TurnX;
-		property MPathSection Slope;
-		property MPathSection SlopeStraight;
-		property MPathSection SlopeStraightL;
-		property MPathSection SlopeStraightR;
-		property MPathSection SlopeMid;
+
+		// Flat ... SlopeMid, see SectionSchema.hpp
+		R3AL_BASIC_PATH_SECTIONS(R3AL_SECTION_PROPERTY)
+
 		property bool UnderwaterSupport;
 		property bool IsExtended;
+		virtual property MBuildProfile Profile; // Release by default
 
 		#pragma region Extended properties
 
 		property unsigned int Unknown01; // Usually 0
 		property unsigned int Unknown02; // Usually 1
-		property MPathSection FlatFC;
-		property MPathSection SlopeFC;
-		property MPathSection SlopeBC;
-		property MPathSection SlopeTC;
-		property MPathSection SlopeStraightFC;
-		property MPathSection SlopeStraightBC;
-		property MPathSection SlopeStraightTC;
-		property MPathSection SlopeStraightLFC;
-		property MPathSection SlopeStraightLBC;
-		property MPathSection SlopeStraightLTC;
-		property MPathSection SlopeStraightRFC;
-		property MPathSection SlopeStraightRBC;
-		property MPathSection SlopeStraightRTC;
-		property MPathSection SlopeMidFC;
-		property MPathSection SlopeMidBC;
-		property MPathSection SlopeMidTC;
-		property MPathSection Paving; // Is actually just a single string in files, but I used MPathSection instead for consistency
+
+		// FlatFC ... SlopeMidTC
+		R3AL_EXTENDED_PATH_SECTIONS(R3AL_SECTION_PROPERTY)
+
+		// Is actually just a single string in files, but I used MPathSection instead for consistency
+		R3AL_SECTION_PROPERTY(Paving, Paving)
+
+	#undef R3AL_SECTION_PROPERTY
 
 		#pragma endregion
 
 		// Constructor.
 		MPath();
 
-		// Copies path model OVL files to the specified destination.
+		// Returns the section at `index` in MSectionSchema::PathSections.
+		//     * Throws System::IndexOutOfRangeException
+		MPathSection GetSection(int index);
+
+		// Sets the section at `index` in MSectionSchema::PathSections.
+		//     * Throws System::IndexOutOfRangeException
+		void SetSection(int index, MPathSection section);
+
+		// Copies path model OVL files to the specified destination. Every file
+		// is checked before the first one is copied.
 		//     * Throws System::Exception-inherited classes
 		void CopyFilesTo(String^ destination);
 	
@@ -125,5 +129,52 @@ namespace R3ALInterop
 		//     * Registers errors to the MOutputLog
 		void CreateBlankOVL(String^ path, MOutputLog^ log);
 
+		// Asynchronous versions of the methods above. The work runs on the
+		// thread pool. `progress` (may be null) receives loaded block and copied
+		// byte counts, see MBuildProgress. Cancelling `token` is checked after
+		// each source texture is loaded, right before the OVL is saved and
+		// between file copy chunks; the task then ends as canceled with nothing
+		// saved. There is no check inside compression: the asset library
+		// compresses textures in OvlFile::Save, which runs to completion.
+		Task^ CreateTextureOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+		Task^ CreateIconOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+		Task^ CreateStubOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+		Task^ CopyFilesToAsync(String^ destination, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+
+		// IOvlProject
+		virtual List<String^>^ GetInputs(MOvlOutputs outputs);
+		virtual List<String^>^ GetSectionModels();
+		virtual bool IsDeterministic(MOvlOutputs outputs);
+		virtual void Build(MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log);
+
+		virtual property Dictionary<String^, String^>^ ModelOvlPaths
+		{
+			Dictionary<String^, String^>^ get() { return _modelOvlPaths; }
+		}
+
+	internal:
+
+		// Runs one output with an optional MBuildControl, for MBuildTask.
+		void Run(MOvlOutputs output, String^ path, MOutputLog^ log, MBuildControl^ control);
+
+		void CreateTextureOVL(String^ path, MOutputLog^ log, MBuildControl^ control);
+		void CreateIconOVL(String^ path, MOutputLog^ log, MBuildControl^ control);
+		void CreateStubOVL(String^ path, MOutputLog^ log, MBuildControl^ control);
+
+		// Saves a texture OVL holding two already built path textures.
+		static void SaveTextureOVL(RCT3Asset::Texture& textureA, RCT3Asset::Texture& textureB, String^ path, MOutputLog^ log);
+
+		// Saves an icon OVL showing `texture` as the "<name>_Icon" GUI skin item.
+		static void SaveIconOVL(RCT3Asset::Texture& texture, String^ name, String^ path, MOutputLog^ log);
+
+		// Returns a copy with another name whose stub refers to the given
+		// texture names instead of the names of TextureA and TextureB.
+		MPath^ CreateVariant(String^ name, String^ ingameName, String^ textureNameA, String^ textureNameB);
+
+	private:
+
+		// Returns the common OVL of every model CopyFilesTo copies.
+		List<String^>^ GetModelFiles();
+
 	};
 }
\ No newline at end of file
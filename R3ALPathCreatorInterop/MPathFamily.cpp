@@ -0,0 +1,173 @@
+// MPathFamily.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MPathFamily.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region MColorTransform
+
+MColorTransform::MColorTransform()
+{
+	Matrix = gcnew array<float>(12) { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0 };
+}
+
+MColorTransform^ MColorTransform::Multiply(float r, float g, float b)
+{
+	MColorTransform^ transform = gcnew MColorTransform();
+	ColorTransform native = ColorTransform::Multiply(r, g, b);
+
+	for (int i = 0; i < 12; i++)
+		transform->Matrix[i] = native.Matrix[i];
+
+	return transform;
+}
+
+MColorTransform^ MColorTransform::Colorize(float r, float g, float b, float amount)
+{
+	MColorTransform^ transform = gcnew MColorTransform();
+	ColorTransform native = ColorTransform::Colorize(r, g, b, amount);
+
+	for (int i = 0; i < 12; i++)
+		transform->Matrix[i] = native.Matrix[i];
+
+	return transform;
+}
+
+ColorTransform MColorTransform::Native()
+{
+	if (Matrix == nullptr || Matrix->Length != 12)
+		throw gcnew ArgumentException("A color transform needs 12 values.");
+
+	ColorTransform native;
+
+	for (int i = 0; i < 12; i++)
+		native.Matrix[i] = Matrix[i];
+
+	return native;
+}
+
+#pragma endregion
+
+#pragma region MPathFamily
+
+MPathFamily::MPathFamily(MPath^ base)
+{
+	Base = base;
+	Variants = gcnew List<MPathVariant^>();
+}
+
+String^ MPathFamily::TextureName(MPathVariant^ variant, String^ file)
+{
+	return variant->Name + "_" + Path::GetFileNameWithoutExtension(file);
+}
+
+bool MPathFamily::BuildTextures(TextureBuilder& builder, String^ file, const TextureOptions& options,
+	const RCT3Asset::TextureStyle& style, int transform, std::vector<RCT3Asset::Texture>& textures)
+{
+	RgbaImage pixels;
+
+	if (!builder.Decode(util::std_string(file), util::std_string(Path::GetFileNameWithoutExtension(file)), options, pixels))
+		return false;
+
+	std::vector<ColorTransform> transforms;
+	std::vector<std::string> names;
+
+	for each (MPathVariant^ variant in Variants)
+	{
+		MColorTransform^ selected = transform == 0 ? variant->TransformA : transform == 1 ? variant->TransformB : variant->IconTransform;
+
+		if (transform == 2 && selected == nullptr)
+			selected = variant->TransformA;
+
+		transforms.push_back(selected != nullptr ? selected->Native() : ColorTransform::Identity());
+		names.push_back(util::std_string(TextureName(variant, file)));
+	}
+
+	return builder.BuildVariants(pixels, transforms, names, style, textures, options);
+}
+
+void MPathFamily::Build(MOvlOutputs outputs, String^ modelDirectory, MOutputLog^ log)
+{
+	// The builder owns the TexImages until every OVL is saved
+	TextureBuilder builder(log->Native());
+
+	std::vector<RCT3Asset::Texture> texturesA;
+	std::vector<RCT3Asset::Texture> texturesB;
+	std::vector<RCT3Asset::Texture> icons;
+
+	if ((outputs & MOvlOutputs::Texture) != MOvlOutputs::None)
+	{
+		TextureOptions options;
+
+		if (!BuildTextures(builder, Base->TextureA, options, RCT3Asset::TextureStyle::PathGround, 0, texturesA) ||
+			!BuildTextures(builder, Base->TextureB, options, RCT3Asset::TextureStyle::PathGround, 1, texturesB))
+			return;
+	}
+
+	if ((outputs & MOvlOutputs::Icon) != MOvlOutputs::None)
+	{
+		TextureOptions options(IconSize, IconSize);
+
+		if (!BuildTextures(builder, Base->Icon, options, RCT3Asset::TextureStyle::GUIIcon, 2, icons))
+			return;
+	}
+
+	for (int i = 0; i < Variants->Count; i++)
+	{
+		MPathVariant^ variant = Variants[i];
+
+		if ((outputs & MOvlOutputs::Texture) != MOvlOutputs::None)
+			MPath::SaveTextureOVL(texturesA[i], texturesB[i], variant->Targets->TextureOVL, log);
+
+		if ((outputs & MOvlOutputs::Icon) != MOvlOutputs::None)
+			MPath::SaveIconOVL(icons[i], variant->Name, variant->Targets->IconOVL, log);
+
+		if ((outputs & (MOvlOutputs::Stub | MOvlOutputs::Blank)) == MOvlOutputs::None)
+			continue;
+
+		MPath^ path = Base->CreateVariant(variant->Name, variant->IngameName,
+			TextureName(variant, Base->TextureA), TextureName(variant, Base->TextureB));
+
+		// Sections refer to the models of Base, unless already redirected
+		for each (String^ model in Base->GetSectionModels())
+		{
+			if (String::IsNullOrWhiteSpace(model))
+				continue;
+
+			String^ name = util::GetOvlName(model);
+
+			if (!path->ModelOvlPaths->ContainsKey(name))
+				path->ModelOvlPaths[name] = "Path\\" + Base->Name + "\\" + name;
+		}
+
+		if ((outputs & MOvlOutputs::Stub) != MOvlOutputs::None)
+			path->CreateStubOVL(variant->Targets->StubOVL, log);
+
+		if ((outputs & MOvlOutputs::Blank) != MOvlOutputs::None)
+			path->CreateBlankOVL(variant->Targets->BlankOVL, log);
+	}
+
+	if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+	{
+		MBuildTargets^ targets = gcnew MBuildTargets();
+		targets->ModelDirectory = modelDirectory;
+
+		Base->Build(MOvlOutputs::Models, targets, log);
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,103 @@
+// MPathFamily.hpp
+// Builds recolored variants of one path in a single pass
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+#include "MPath.hpp"
+
+namespace R3ALInterop
+{
+
+	// Affine color change of a texture, see ColorTransform.
+	public ref class MColorTransform
+	{
+	public:
+		property array<float>^ Matrix; // 3 rows of (r, g, b, offset) on 0-255 values
+
+		// Constructor, leaves colors unchanged.
+		MColorTransform();
+
+		// Scales each channel, 1 keeps it.
+		static MColorTransform^ Multiply(float r, float g, float b);
+
+		// Replaces the hue with (r, g, b) while keeping the shading, blended
+		// with the original color by `amount` (0 to 1).
+		static MColorTransform^ Colorize(float r, float g, float b, float amount);
+
+	internal:
+
+		ColorTransform Native();
+
+	};
+
+	// One colorway of an MPathFamily.
+	public ref class MPathVariant
+	{
+	public:
+		property String^ Name;
+		property String^ IngameName;
+		property MColorTransform^ TransformA;     // null = unchanged
+		property MColorTransform^ TransformB;     // null = unchanged
+		property MColorTransform^ IconTransform;  // null = TransformA
+		property MBuildTargets^ Targets;          // ModelDirectory is not used, see MPathFamily::Build
+
+		// Constructor.
+		MPathVariant()
+		{
+			Name = "";
+			IngameName = "";
+			Targets = gcnew MBuildTargets();
+		}
+	};
+
+	// Paths that only differ in texture color and name. The textures and icon
+	// of Base are decoded once, then recolored and compressed for every
+	// variant in parallel, so each extra variant costs about one texture
+	// compression. Variants share the models of Base.
+	public ref class MPathFamily
+	{
+	private:
+
+		// Names a texture of a variant after the variant and the source file.
+		static String^ TextureName(MPathVariant^ variant, String^ file);
+
+		// Decodes `file` once and builds one texture per variant from it.
+		//     * Registers errors to the MOutputLog, returns false on failure
+		bool BuildTextures(TextureBuilder& builder, String^ file, const TextureOptions& options,
+			const RCT3Asset::TextureStyle& style, int transform, std::vector<RCT3Asset::Texture>& textures);
+
+	public:
+		property MPath^ Base;
+		property List<MPathVariant^>^ Variants;
+
+		// Constructor.
+		MPathFamily(MPath^ base);
+
+		// Builds `outputs` for every variant into its Targets. Models are
+		// copied once, to `modelDirectory`, which must be the game's
+		// "Path\<Base.Name>\" directory: every variant stub refers to them
+		// there.
+		//     * Registers errors to the MOutputLog
+		//     * Models: throws System::Exception-inherited classes, see MPath::CopyFilesTo
+		void Build(MOvlOutputs outputs, String^ modelDirectory, MOutputLog^ log);
+
+	};
+
+}
@@ -0,0 +1,303 @@
+// MProjectWatcher.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MProjectWatcher.hpp"
+#include "MStagedInstall.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Threading;
+
+#pragma region MProjectWatcher
+
+MProjectWatcher::MProjectWatcher(IOvlProject^ project, String^ projectFile, MBuildTargets^ targets, MOutputLog^ log)
+	: _project(project), _targets(targets), _log(log)
+{
+	_projectFile = String::IsNullOrWhiteSpace(projectFile) ? nullptr : Path::GetFullPath(projectFile);
+
+	_inputs = gcnew Dictionary<String^, MOvlOutputs>(StringComparer::OrdinalIgnoreCase);
+	_watchers = gcnew List<FileSystemWatcher^>();
+	_timer = gcnew Timer(gcnew TimerCallback(this, &MProjectWatcher::OnElapsed), nullptr, Timeout::Infinite, Timeout::Infinite);
+
+	_pendingLock = gcnew Object();
+	_buildLock = gcnew Object();
+	_pending = MOvlOutputs::None;
+	_changed = gcnew HashSet<String^>(StringComparer::OrdinalIgnoreCase);
+	_reload = false;
+
+	Debounce = 150;
+}
+
+MProjectWatcher::~MProjectWatcher()
+{
+	Stop();
+	delete _timer;
+}
+
+void MProjectWatcher::Start()
+{
+	Stop();
+	Index();
+}
+
+void MProjectWatcher::Stop()
+{
+	for each (FileSystemWatcher^ watcher in _watchers)
+	{
+		watcher->EnableRaisingEvents = false;
+		delete watcher;
+	}
+
+	_watchers->Clear();
+
+	Monitor::Enter(_pendingLock);
+	try
+	{
+		_timer->Change(Timeout::Infinite, Timeout::Infinite);
+		_pending = MOvlOutputs::None;
+		_changed->Clear();
+		_reload = false;
+	}
+	finally
+	{
+		Monitor::Exit(_pendingLock);
+	}
+
+	// Let a rebuild that already started finish
+	Monitor::Enter(_buildLock);
+	Monitor::Exit(_buildLock);
+}
+
+void MProjectWatcher::Index()
+{
+	// Built aside and swapped in, watcher threads look files up concurrently
+	Dictionary<String^, MOvlOutputs>^ inputs = gcnew Dictionary<String^, MOvlOutputs>(StringComparer::OrdinalIgnoreCase);
+
+	array<MOvlOutputs>^ outputs = { MOvlOutputs::Texture, MOvlOutputs::Icon, MOvlOutputs::Stub, MOvlOutputs::Blank, MOvlOutputs::Models };
+
+	for each (MOvlOutputs output in outputs)
+	{
+		for each (String^ input in _project->GetInputs(output))
+		{
+			if (String::IsNullOrWhiteSpace(input))
+				continue;
+
+			String^ fullPath = Path::GetFullPath(input);
+			MOvlOutputs existing;
+
+			if (inputs->TryGetValue(fullPath, existing))
+				inputs[fullPath] = existing | output;
+			else
+				inputs[fullPath] = output;
+		}
+	}
+
+	Monitor::Enter(_pendingLock);
+	try
+	{
+		_inputs = inputs;
+	}
+	finally
+	{
+		Monitor::Exit(_pendingLock);
+	}
+
+	HashSet<String^>^ directories = gcnew HashSet<String^>(StringComparer::OrdinalIgnoreCase);
+
+	for each (String^ input in inputs->Keys)
+		directories->Add(Path::GetDirectoryName(input));
+
+	if (_projectFile != nullptr)
+		directories->Add(Path::GetDirectoryName(_projectFile));
+
+	for each (String^ directory in directories)
+		Watch(directory);
+}
+
+void MProjectWatcher::Watch(String^ directory)
+{
+	if (!Directory::Exists(directory))
+	{
+		_log->Warning(String::Format("Cannot watch \"{0}\", directory does not exist.", directory));
+		return;
+	}
+
+	FileSystemWatcher^ watcher = gcnew FileSystemWatcher(directory);
+	watcher->IncludeSubdirectories = false;
+	watcher->NotifyFilter = NotifyFilters::LastWrite | NotifyFilters::FileName | NotifyFilters::Size;
+
+	// Editors that save through a temporary file show up as Created/Renamed
+	watcher->Changed += gcnew FileSystemEventHandler(this, &MProjectWatcher::OnChanged);
+	watcher->Created += gcnew FileSystemEventHandler(this, &MProjectWatcher::OnChanged);
+	watcher->Renamed += gcnew RenamedEventHandler(this, &MProjectWatcher::OnRenamed);
+
+	watcher->EnableRaisingEvents = true;
+	_watchers->Add(watcher);
+}
+
+void MProjectWatcher::OnChanged(Object^ sender, FileSystemEventArgs^ e)
+{
+	Enqueue(e->FullPath);
+}
+
+void MProjectWatcher::OnRenamed(Object^ sender, RenamedEventArgs^ e)
+{
+	Enqueue(e->FullPath);
+}
+
+void MProjectWatcher::Enqueue(String^ fullPath)
+{
+	bool isProject = _projectFile != nullptr && String::Equals(fullPath, _projectFile, StringComparison::OrdinalIgnoreCase);
+	MOvlOutputs outputs;
+
+	Monitor::Enter(_pendingLock);
+	try
+	{
+		if (!isProject && !_inputs->TryGetValue(fullPath, outputs))
+			return;
+
+		if (isProject)
+		{
+			_reload = true;
+			_pending = MOvlOutputs::All;
+		}
+		else
+		{
+			_pending = _pending | outputs;
+			_changed->Add(fullPath);
+		}
+
+		// Restarts the countdown, so bursts of changes coalesce
+		_timer->Change(Debounce, Timeout::Infinite);
+	}
+	finally
+	{
+		Monitor::Exit(_pendingLock);
+	}
+}
+
+void MProjectWatcher::OnElapsed(Object^ state)
+{
+	// Changes arriving during a rebuild re-arm the timer and are picked up
+	// by the next rebuild, which waits here until this one is done
+	Monitor::Enter(_buildLock);
+	try
+	{
+		MOvlOutputs outputs;
+		List<String^>^ changed;
+		bool reload;
+		Dictionary<String^, MOvlOutputs>^ inputs;
+
+		Monitor::Enter(_pendingLock);
+		try
+		{
+			outputs = _pending;
+			changed = gcnew List<String^>(_changed);
+			reload = _reload;
+			inputs = _inputs;
+
+			_pending = MOvlOutputs::None;
+			_changed->Clear();
+			_reload = false;
+		}
+		finally
+		{
+			Monitor::Exit(_pendingLock);
+		}
+
+		if (outputs == MOvlOutputs::None)
+			return;
+
+		Diagnostics::Stopwatch^ watch = Diagnostics::Stopwatch::StartNew();
+		unsigned int errors = _log->GetErrorCount();
+
+		try
+		{
+			if (reload)
+			{
+				if (Loader != nullptr)
+					_project = Loader(_projectFile);
+
+				// Inputs may have been added or removed
+				Start();
+			}
+
+			// Built into staging, installed only if the whole rebuild worked
+			MStagedInstall^ install = gcnew MStagedInstall();
+
+			try
+			{
+				MBuildTargets^ staged = install->StageTargets(_targets);
+
+				_project->Build(outputs & ~MOvlOutputs::Models, staged, _log);
+
+				// Model OVLs are copied as they are, so unless the project itself
+				// changed only the changed sections are copied over
+				if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+				{
+					List<String^>^ models = reload ? _project->GetInputs(MOvlOutputs::Models) : changed;
+
+					for each (String^ model in models)
+					{
+						MOvlOutputs dependents;
+
+						if (!reload && (!inputs->TryGetValue(model, dependents) || (dependents & MOvlOutputs::Models) == MOvlOutputs::None))
+							continue;
+
+						if (File::Exists(model))
+							File::Copy(model, staged->ModelDirectory + Path::GetFileName(model), true);
+					}
+				}
+
+				if (_log->GetErrorCount() == errors)
+					install->Commit();
+			}
+			finally
+			{
+				delete install;
+			}
+		}
+		catch (Exception^ e)
+		{
+			_log->Error(String::Format("Rebuild failed: {0}", e->Message));
+		}
+
+		watch->Stop();
+
+		_log->Info(String::Format("Rebuilt {0} in {1} ms ({2} changed files).", outputs, watch->ElapsedMilliseconds, changed->Count));
+
+		MRebuildEventArgs^ args = gcnew MRebuildEventArgs();
+		args->Outputs = outputs;
+		args->ChangedFiles = changed;
+		args->Elapsed = watch->Elapsed;
+		args->Errors = _log->GetErrorCount() - errors;
+
+		// A throwing handler must not take down the timer thread
+		try
+		{
+			Rebuilt(this, args);
+		}
+		catch (Exception^ e)
+		{
+			_log->Error(String::Format("Rebuilt handler failed: {0}", e->Message));
+		}
+	}
+	finally
+	{
+		Monitor::Exit(_buildLock);
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,103 @@
+// MProjectWatcher.hpp
+// Rebuilds the outputs of a path or queue project as its source files change
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+
+namespace R3ALInterop
+{
+
+	// Describes one rebuild.
+	public ref class MRebuildEventArgs : EventArgs
+	{
+	public:
+		property MOvlOutputs Outputs;
+		property List<String^>^ ChangedFiles;
+		property TimeSpan Elapsed;
+		property unsigned int Errors; // Errors logged during this rebuild
+	};
+
+	// Returns the project reloaded from its project file.
+	public delegate IOvlProject^ OvlProjectLoader(String^ projectFile);
+
+	// Watches every file a project is built from and rebuilds only the outputs
+	// that depend on the files that changed. Changes are collected until no
+	// new change arrived for Debounce milliseconds, so saving many files at
+	// once causes a single rebuild. Rebuilds run on a thread pool thread, one
+	// at a time.
+	public ref class MProjectWatcher
+	{
+	private:
+		IOvlProject^ _project;
+		MBuildTargets^ _targets;
+		MOutputLog^ _log;
+		String^ _projectFile;
+
+		Dictionary<String^, MOvlOutputs>^ _inputs;  // Full path -> outputs depending on it, replaced whole under _pendingLock
+		List<FileSystemWatcher^>^ _watchers;
+		Threading::Timer^ _timer;
+
+		Object^ _pendingLock;  // Guards _inputs and the pending changes
+		Object^ _buildLock;
+		MOvlOutputs _pending;
+		HashSet<String^>^ _changed;
+		bool _reload;
+
+	public:
+		property int Debounce; // Milliseconds, 150 by default
+
+		// Called when the project file changes. If not set, the project object
+		// is assumed to be kept up to date by its owner and is rebuilt as is.
+		property OvlProjectLoader^ Loader;
+
+		// Raised after every rebuild, on the rebuilding thread. Exceptions
+		// thrown by handlers are logged.
+		event EventHandler<MRebuildEventArgs^>^ Rebuilt;
+
+		// Constructor. `projectFile` may be null.
+		MProjectWatcher(IOvlProject^ project, String^ projectFile, MBuildTargets^ targets, MOutputLog^ log);
+
+		// Dispose
+		~MProjectWatcher();
+
+		// Starts watching. Nothing is built until a file changes.
+		void Start();
+
+		// Stops watching and drops pending changes. Waits for a running rebuild.
+		void Stop();
+
+	private:
+
+		// Maps the project's inputs to outputs and creates one watcher per directory.
+		void Index();
+
+		void Watch(String^ directory);
+
+		void OnChanged(Object^ sender, FileSystemEventArgs^ e);
+
+		void OnRenamed(Object^ sender, RenamedEventArgs^ e);
+
+		void Enqueue(String^ fullPath);
+
+		void OnElapsed(Object^ state);
+
+	};
+
+}
@@ -18,57 +18,96 @@
 
 using namespace R3ALInterop;
 
-#pragma region Macros
-
-#define DOQUEUESECTION(QSECTION) sid.Name(qtd.QSECTION); \
-	sid.TxtName = text; \
-	sid.GsiIcon = qtd.GsiIcon; \
-	sid.OvlPath = ovlPath + qtd.QSECTION; \
-	sid.Svds.push_back(qtd.QSECTION + ":svd"); \
-	sidCol.Add(sid); \
-	sid.Svds.clear();
-
-#pragma endregion
-
 #pragma region MQueue
 
 MQueue::MQueue()
 {
+	_sections = gcnew array<String^>(static_cast<int>(QueueSectionCount));
+
+	for (int i = 0; i < _sections->Length; i++)
+		_sections[i] = "";
+
 	Name = "";
 	IngameName = "";
+	Profile = MBuildProfile::Release;
 	Icon = "";
 	Texture = "";
 	Shared = "";
-	Straight = "";
-	TurnL = "";
-	TurnR = "";
-	SlopeUp = "";
-	SlopeDown = "";
-	SlopeStraight1 = "";
-	SlopeStraight2 = "";
 	Recolor1 = false;
 	Recolor2 = false;
 	Recolor3 = false;
+	_modelOvlPaths = gcnew Dictionary<String^, String^>(StringComparer::OrdinalIgnoreCase);
 }
 
 void MQueue::CopyFilesTo(String^ destination)
 {
-	util::CopyOvlFile(Straight, destination);
-	util::CopyOvlFile(TurnL, destination);
-	util::CopyOvlFile(TurnR, destination);
-	util::CopyOvlFile(SlopeUp, destination);
-	util::CopyOvlFile(SlopeDown, destination);
-	util::CopyOvlFile(SlopeStraight1, destination);
+	util::CopyOvlFiles(GetModelFiles(), destination);
+}
+
+String^ MQueue::GetSection(int index)
+{
+	return _sections[index];
+}
+
+void MQueue::SetSection(int index, String^ section)
+{
+	_sections[index] = section;
+}
+
+List<String^>^ MQueue::GetSectionModels()
+{
+	List<String^>^ files = gcnew List<String^>();
+
+	for (int i = 0; i < _sections->Length; i++)
+	{
+		String^ file = _sections[i];
+
+		if (i == static_cast<int>(QueueSectionId::SlopeStraight2) && String::Equals(file, SlopeStraight1))
+			continue;
+
+		if (IsSectionUsed(QueueSections[i], !String::IsNullOrWhiteSpace(file), false))
+			files->Add(file);
+	}
+
+	return files;
+}
+
+List<String^>^ MQueue::GetModelFiles()
+{
+	List<String^>^ files = GetSectionModels();
+
+	if (!String::IsNullOrWhiteSpace(Shared))
+		files->Add(Shared);
+
+	return files;
+}
 
-	util::CopyOvlFileOptional(Shared, destination);
+std::vector<std::string> MQueue::GetModelNames()
+{
+	std::vector<std::string> models(QueueSectionCount);
 
-	if (SlopeStraight2 != SlopeStraight1 && !String::IsNullOrWhiteSpace(SlopeStraight2))
+	for (size_t i = 0; i < QueueSectionCount; i++)
 	{
-		util::CopyOvlFile(SlopeStraight2, destination);
+		String^ file = _sections[static_cast<int>(i)];
+
+		if (!String::IsNullOrWhiteSpace(file))
+			models[i] = util::GetOvlName_std(file);
 	}
+
+	std::string& slopeStraight2 = models[static_cast<size_t>(QueueSectionId::SlopeStraight2)];
+
+	if (slopeStraight2 == models[static_cast<size_t>(QueueSectionId::SlopeStraight1)])
+		slopeStraight2.clear();
+
+	return models;
 }
 
 void MQueue::CreateTextureOVL(String^ path, MOutputLog^ log)
+{
+	CreateTextureOVL(path, log, nullptr);
+}
+
+void MQueue::CreateTextureOVL(String^ path, MOutputLog^ log, MBuildControl^ control)
 {
 	RCT3Asset::OvlFile ovl(log->Native());
 
@@ -95,25 +134,36 @@ void MQueue::CreateTextureOVL(String^ path, MOutputLog^ log)
 
 	ftxCol.AddTo(ovl);
 
-	ovl.Save(util::std_string(path));
+	MBuildControl::ThrowIfCancelled(control);
+
+	util::SaveOvl(ovl, path, log->Native());
 }
 
 void MQueue::CreateIconOVL(String^ path, MOutputLog^ log)
+{
+	CreateIconOVL(path, log, nullptr);
+}
+
+void MQueue::CreateIconOVL(String^ path, MOutputLog^ log, MBuildControl^ control)
 {
 	RCT3Asset::OvlFile ovl(log->Native());
 
 	RCT3Asset::TextureStyle txs = RCT3Asset::TextureStyle::GUIIcon;
 	txs.AddTo(ovl);
 
-	RCT3Asset::TexImage imgIcon(log->Native());
-	imgIcon.FromFile(util::std_string(Icon));
-
-	RCT3Asset::TextureMip mainMip(imgIcon);
+	TextureBuilder builder(log->Native());
 
 	RCT3Asset::Texture tex;
-	tex.Name(util::std_string(Path::GetFileNameWithoutExtension(Icon)));
-	tex.TxsStyle = txs;
-	tex.Mips.push_back(mainMip);
+
+	TextureOptions options(IconSize, IconSize);
+	options.Control = control != nullptr ? control->Native() : nullptr;
+
+	if (!builder.Build(util::std_string(Icon), util::std_string(Path::GetFileNameWithoutExtension(Icon)), txs, tex, options))
+	{
+		// Build stops without an error when cancelled
+		MBuildControl::ThrowIfCancelled(control);
+		return;
+	}
 
 	RCT3Asset::GuiSkinItem gsiIcon;
 	gsiIcon.Name(util::std_string(Name + "_Icon"));
@@ -122,8 +172,8 @@ void MQueue::CreateIconOVL(String^ path, MOutputLog^ log)
 
 	pos.Top = 0;
 	pos.Left = 0;
-	pos.Right = 40;
-	pos.Bottom = 40;
+	pos.Right = IconSize;
+	pos.Bottom = IconSize;
 
 	gsiIcon.Position = pos;
 	gsiIcon.Texture = tex;
@@ -140,10 +190,17 @@ void MQueue::CreateIconOVL(String^ path, MOutputLog^ log)
 	texCol.Add(tex);
 	texCol.AddTo(ovl);
 
-	ovl.Save(util::std_string(path));
+	MBuildControl::ThrowIfCancelled(control);
+
+	util::SaveOvl(ovl, path, log->Native());
 }
 
 void MQueue::CreateStubOVL(String^ path, MOutputLog^ log)
+{
+	CreateStubOVL(path, log, nullptr);
+}
+
+void MQueue::CreateStubOVL(String^ path, MOutputLog^ log, MBuildControl^ control)
 {
 	RCT3Asset::OvlFile ovl(log->Native());
 
@@ -153,7 +210,7 @@ void MQueue::CreateStubOVL(String^ path, MOutputLog^ log)
 
 	RCT3Asset::TextString text;
 	text.Name(util::std_string(Name + "_Text"));
-	text.Text(util::std_wstring(IngameName));
+	text.Text(util::std_wstring(ProfileSettings::IngameName(Profile, IngameName)));
 
 	RCT3Asset::TextStringCollection txtCol;
 	txtCol.Add(text);
@@ -165,16 +222,12 @@ void MQueue::CreateStubOVL(String^ path, MOutputLog^ log)
 	qtd.Text = text;
 	qtd.FtxTexture = util::std_string(Path::GetFileNameWithoutExtension(Texture)) + ":ftx";
 
-	qtd.Straight = util::GetOvlName_std(Straight);
-	qtd.TurnL = util::GetOvlName_std(TurnL);
-	qtd.TurnR = util::GetOvlName_std(TurnR);
-	qtd.SlopeUp = util::GetOvlName_std(SlopeUp);
-	qtd.SlopeDown = util::GetOvlName_std(SlopeDown);
-	qtd.SlopeStraight1 = util::GetOvlName_std(SlopeStraight1);
+	std::vector<std::string> models = GetModelNames();
 
-	if (SlopeStraight2 != SlopeStraight1 && !String::IsNullOrWhiteSpace(SlopeStraight2))
-		qtd.SlopeStraight2 = util::GetOvlName_std(SlopeStraight2);
-	else
+	SetQueueSections(qtd, models);
+
+	// The stub always names both slope straights
+	if (models[static_cast<size_t>(QueueSectionId::SlopeStraight2)].empty())
 		qtd.SlopeStraight2 = qtd.SlopeStraight1;
 
 	RCT3Asset::QueueCollection qtdCol;
@@ -190,30 +243,133 @@ void MQueue::CreateStubOVL(String^ path, MOutputLog^ log)
 	sid.Size.Y = 3.0f;
 	sid.Size.Z = 4.0f;
 
-	DOQUEUESECTION(Straight);
-	DOQUEUESECTION(TurnL);
-	DOQUEUESECTION(TurnR);
-	DOQUEUESECTION(SlopeUp);
-	DOQUEUESECTION(SlopeDown);
-	DOQUEUESECTION(SlopeStraight1);
-
-	if (SlopeStraight2 != SlopeStraight1 && !String::IsNullOrWhiteSpace(SlopeStraight2))
+	for (size_t i = 0; i < QueueSectionCount; i++)
 	{
-		DOQUEUESECTION(SlopeStraight2);
+		if (!IsSectionUsed(QueueSections[i], !models[i].empty(), false))
+			continue;
+
+		sid.Name(models[i]);
+		sid.TxtName = text;
+		sid.GsiIcon = qtd.GsiIcon;
+		sid.OvlPath = util::ModelOvlPath(_modelOvlPaths, ovlPath, models[i]);
+		sid.Svds.push_back(models[i] + ":svd");
+		sidCol.Add(sid);
+		sid.Svds.clear();
 	}
 
 	qtdCol.AddTo(ovl);
 	sidCol.AddTo(ovl);
 	txtCol.AddTo(ovl);
 
-	ovl.Save(marshal_as<std::string>(path));
+	MBuildControl::ThrowIfCancelled(control);
+
+	util::SaveOvl(ovl, path, log->Native());
 }
 
 void MQueue::CreateBlankOVL(String^ path, MOutputLog^ log)
 {
 	RCT3Asset::OvlFile ovl(log->Native());
 
-	ovl.Save(util::std_string(path));
+	util::SaveOvl(ovl, path, log->Native());
+}
+
+void MQueue::Run(MOvlOutputs output, String^ path, MOutputLog^ log, MBuildControl^ control)
+{
+	switch (output)
+	{
+	case MOvlOutputs::Texture:
+		CreateTextureOVL(path, log, control);
+		break;
+	case MOvlOutputs::Icon:
+		CreateIconOVL(path, log, control);
+		break;
+	case MOvlOutputs::Stub:
+		CreateStubOVL(path, log, control);
+		break;
+	case MOvlOutputs::Blank:
+		CreateBlankOVL(path, log);
+		break;
+	case MOvlOutputs::Models:
+		control->CopyOvlFiles(GetModelFiles(), path);
+		break;
+	default:
+		break;
+	}
+}
+
+Task^ MQueue::CreateTextureOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MQueue>(this, MOvlOutputs::Texture, path, log), progress, token);
+}
+
+Task^ MQueue::CreateIconOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MQueue>(this, MOvlOutputs::Icon, path, log), progress, token);
+}
+
+Task^ MQueue::CreateStubOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MQueue>(this, MOvlOutputs::Stub, path, log), progress, token);
+}
+
+Task^ MQueue::CopyFilesToAsync(String^ destination, IProgress<MBuildProgress^>^ progress, CancellationToken token)
+{
+	return MBuildTask::Run(gcnew ProjectBuildJob<MQueue>(this, MOvlOutputs::Models, destination, nullptr), progress, token);
+}
+
+bool MQueue::IsDeterministic(MOvlOutputs)
+{
+	return true;
+}
+
+List<String^>^ MQueue::GetInputs(MOvlOutputs outputs)
+{
+	List<String^>^ inputs = gcnew List<String^>();
+
+	if ((outputs & MOvlOutputs::Texture) != MOvlOutputs::None)
+		inputs->Add(Texture);
+
+	if ((outputs & MOvlOutputs::Icon) != MOvlOutputs::None)
+		inputs->Add(Icon);
+
+	// Stub and blank OVLs only depend on properties
+	if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+	{
+		for each (String^ model in GetModelFiles())
+			util::AddOvlFiles(inputs, model);
+	}
+
+	return inputs;
+}
+
+void MQueue::Build(MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log)
+{
+	if ((outputs & MOvlOutputs::Texture) != MOvlOutputs::None)
+		CreateTextureOVL(targets->TextureOVL, log);
+
+	if ((outputs & MOvlOutputs::Icon) != MOvlOutputs::None)
+		CreateIconOVL(targets->IconOVL, log);
+
+	if ((outputs & MOvlOutputs::Stub) != MOvlOutputs::None)
+		CreateStubOVL(targets->StubOVL, log);
+
+	if ((outputs & MOvlOutputs::Blank) != MOvlOutputs::None)
+		CreateBlankOVL(targets->BlankOVL, log);
+
+	if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+	{
+		if (ProfileSettings::CanReuseModels(this, targets->ModelDirectory))
+		{
+			log->Info("Draft build: model OVLs are already installed, not copying them.");
+		}
+		else
+		{
+			StageTimer timer(MetricsFor(log->Native()), Stage::Copy);
+
+			CopyFilesTo(targets->ModelDirectory);
+			util::RecordOvlCopies(GetModelFiles(), log->Native());
+		}
+	}
 }
 
 #pragma endregion
\ No newline at end of file
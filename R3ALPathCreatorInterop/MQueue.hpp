@@ -26,34 +26,59 @@
 #include "System.hpp"
 #include "Utilities.hpp"
 #include "MOutputLog.hpp"
+#include "TextureBuilder.hpp"
+#include "OvlProject.hpp"
+#include "MBuildTask.hpp"
+#include "SectionSchema.hpp"
 
 namespace R3ALInterop
 {
 
+	// Section property backed by MQueue::_sections.
+	#define R3AL_QUEUE_PROPERTY(PROPERTY, ...) \
+		property String^ PROPERTY \
+		{ \
+			String^ get() { return _sections[static_cast<int>(QueueSectionId::PROPERTY)]; } \
+			void set(String^ value) { _sections[static_cast<int>(QueueSectionId::PROPERTY)] = value; } \
+		}
+
 	// Managed wrapper class for RCT3Asset::Queue class.
-	public ref class MQueue
+	public ref class MQueue : IOvlProject
 	{
+	private:
+		array<String^>^ _sections;  // By QueueSectionId
+		Dictionary<String^, String^>^ _modelOvlPaths;
+
 	public:
 		property String^ Name;
 		property String^ IngameName;
 		property String^ Icon;
 		property String^ Texture;
 		property String^ Shared; // Path to shared texture OVL, is not required for creating paths
-		property String^ Straight;
-		property String^ TurnL;
-		property String^ TurnR;
-		property String^ SlopeUp;
-		property String^ SlopeDown;
-		property String^ SlopeStraight1;
-		property String^ SlopeStraight2;
+
+		// Straight ... SlopeStraight2, see SectionSchema.hpp
+		R3AL_QUEUE_SECTIONS(R3AL_QUEUE_PROPERTY)
+
+	#undef R3AL_QUEUE_PROPERTY
+
 		property bool Recolor1;
 		property bool Recolor2;
 		property bool Recolor3;
+		virtual property MBuildProfile Profile; // Release by default
 
 		// Constructor.
 		MQueue();
 
-		// Copies queue model OVL files to the specified destination.
+		// Returns the model OVL of the section at `index` in MSectionSchema::QueueSections.
+		//     * Throws System::IndexOutOfRangeException
+		String^ GetSection(int index);
+
+		// Sets the model OVL of the section at `index` in MSectionSchema::QueueSections.
+		//     * Throws System::IndexOutOfRangeException
+		void SetSection(int index, String^ section);
+
+		// Copies queue model OVL files to the specified destination. Every file
+		// is checked before the first one is copied.
 		//     * Throws System::Exception-inherited classes
 		void CopyFilesTo(String^ destination);
 
@@ -73,6 +98,47 @@ namespace R3ALInterop
 		//     * Registers errors to the MOutputLog
 		void CreateBlankOVL(String^ path, MOutputLog^ log);
 
+		// Asynchronous versions of the methods above. The work runs on the
+		// thread pool. `progress` (may be null) receives loaded block and copied
+		// byte counts, see MBuildProgress. Cancelling `token` is checked after
+		// each source texture is loaded, right before the OVL is saved and
+		// between file copy chunks; the task then ends as canceled with nothing
+		// saved. There is no check inside compression: the asset library
+		// compresses textures in OvlFile::Save, which runs to completion.
+		Task^ CreateTextureOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+		Task^ CreateIconOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+		Task^ CreateStubOVLAsync(String^ path, MOutputLog^ log, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+		Task^ CopyFilesToAsync(String^ destination, IProgress<MBuildProgress^>^ progress, CancellationToken token);
+
+		// IOvlProject
+		virtual List<String^>^ GetInputs(MOvlOutputs outputs);
+		virtual List<String^>^ GetSectionModels();
+		virtual bool IsDeterministic(MOvlOutputs outputs);
+		virtual void Build(MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log);
+
+		virtual property Dictionary<String^, String^>^ ModelOvlPaths
+		{
+			Dictionary<String^, String^>^ get() { return _modelOvlPaths; }
+		}
+
+	internal:
+
+		// Runs one output with an optional MBuildControl, for MBuildTask.
+		void Run(MOvlOutputs output, String^ path, MOutputLog^ log, MBuildControl^ control);
+
+		void CreateTextureOVL(String^ path, MOutputLog^ log, MBuildControl^ control);
+		void CreateIconOVL(String^ path, MOutputLog^ log, MBuildControl^ control);
+		void CreateStubOVL(String^ path, MOutputLog^ log, MBuildControl^ control);
+
+	private:
+
+		// Returns the common OVL of every model CopyFilesTo copies.
+		List<String^>^ GetModelFiles();
+
+		// Returns the model name of each section for the stub, "" for a
+		// SlopeStraight2 that only repeats SlopeStraight1.
+		std::vector<std::string> GetModelNames();
+
 	};
 
 }
\ No newline at end of file
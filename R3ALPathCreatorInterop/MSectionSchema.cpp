@@ -0,0 +1,69 @@
+// MSectionSchema.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+
+#include "MSectionSchema.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region MSectionInfo
+
+MSectionInfo::MSectionInfo(int index, const SectionInfo& section)
+{
+	Index = index;
+	Name = gcnew String(section.Name);
+	Role = section.Role ? gcnew String(section.Role) : nullptr;
+	Set = static_cast<MSectionSet>(section.Set);
+	Required = section.Required;
+}
+
+#pragma endregion
+
+#pragma region MSectionSchema
+
+IReadOnlyList<MSectionInfo^>^ MSectionSchema::Create(const SectionInfo* sections, size_t count)
+{
+	array<MSectionInfo^>^ infos = gcnew array<MSectionInfo^>(static_cast<int>(count));
+
+	for (int i = 0; i < infos->Length; i++)
+		infos[i] = gcnew MSectionInfo(i, sections[i]);
+
+	return Array::AsReadOnly<MSectionInfo^>(infos);
+}
+
+MSectionInfo^ MSectionSchema::FindPathRole(String^ role)
+{
+	for each (MSectionInfo^ section in _pathSections)
+	{
+		if (String::Equals(section->Role, role, StringComparison::OrdinalIgnoreCase))
+			return section;
+	}
+
+	return nullptr;
+}
+
+MSectionInfo^ MSectionSchema::FindQueueRole(String^ role)
+{
+	for each (MSectionInfo^ section in _queueSections)
+	{
+		if (section->Role != nullptr && String::Equals(section->Role, role, StringComparison::OrdinalIgnoreCase))
+			return section;
+	}
+
+	return nullptr;
+}
+
+#pragma endregion
@@ -0,0 +1,79 @@
+// MSectionSchema.hpp
+// Managed view of the path and queue section tables
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "SectionSchema.hpp"
+
+namespace R3ALInterop
+{
+
+	public enum class MSectionSet
+	{
+		Basic,     // Required by every path
+		Extended,  // Optional, only used by extended paths
+		Queue
+	};
+
+	// One model section of a path or queue, see SectionSchema.hpp.
+	public ref class MSectionInfo
+	{
+	public:
+		property int Index;       // For MPath/MQueue GetSection and SetSection
+		property String^ Name;    // MPath/MQueue property
+		property String^ Role;    // Model name suffix OvlModelSearcher matches, null if not searched for
+		property MSectionSet Set;
+		property bool Required;   // Optional sections may be left empty
+
+	internal:
+
+		MSectionInfo(int index, const SectionInfo& section);
+
+	};
+
+	// The model sections of paths and queues in project file order: the
+	// basic path sections come first, then the extended ones.
+	public ref class MSectionSchema abstract sealed
+	{
+	private:
+		static initonly IReadOnlyList<MSectionInfo^>^ _pathSections = Create(R3ALInterop::PathSections, PathSectionCount);
+		static initonly IReadOnlyList<MSectionInfo^>^ _queueSections = Create(R3ALInterop::QueueSections, QueueSectionCount);
+
+		static IReadOnlyList<MSectionInfo^>^ Create(const SectionInfo* sections, size_t count);
+
+	public:
+
+		static property IReadOnlyList<MSectionInfo^>^ PathSections
+		{
+			IReadOnlyList<MSectionInfo^>^ get() { return _pathSections; }
+		}
+
+		static property IReadOnlyList<MSectionInfo^>^ QueueSections
+		{
+			IReadOnlyList<MSectionInfo^>^ get() { return _queueSections; }
+		}
+
+		// Returns the path section with the given role, or null.
+		static MSectionInfo^ FindPathRole(String^ role);
+
+		// Returns the queue section with the given role, or null.
+		static MSectionInfo^ FindQueueRole(String^ role);
+
+	};
+
+}
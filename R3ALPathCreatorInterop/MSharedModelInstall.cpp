@@ -0,0 +1,241 @@
+// MSharedModelInstall.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MSharedModelInstall.hpp"
+#include "ContentHash.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region Private
+
+void MSharedModelInstall::Store(String^ model, String^ key, MStagedInstall^ install)
+{
+	String^ directory = Path::Combine(StoreDirectory, key);
+	String^ unique = model->Replace("common.ovl", "unique.ovl");
+
+	String^ storedCommon = Path::Combine(directory, Path::GetFileName(model));
+	String^ storedUnique = Path::Combine(directory, Path::GetFileName(unique));
+
+	if (File::Exists(storedCommon) && File::Exists(storedUnique) &&
+		util::SameFileContents(model, storedCommon) && util::SameFileContents(unique, storedUnique))
+		return;
+
+	File::Copy(model, install->Stage(storedCommon), true);
+	File::Copy(unique, install->Stage(storedUnique), true);
+}
+
+#pragma endregion
+
+#pragma region Public
+
+MSharedModelInstall::MSharedModelInstall(String^ storeDirectory, String^ storeOvlPath)
+	: _projects(gcnew List<IOvlProject^>()), _targets(gcnew List<MBuildTargets^>())
+{
+	StoreDirectory = storeDirectory;
+	StoreOvlPath = storeOvlPath->EndsWith("\\") ? storeOvlPath : storeOvlPath + "\\";
+}
+
+void MSharedModelInstall::Add(IOvlProject^ project, MBuildTargets^ targets)
+{
+	_projects->Add(project);
+	_targets->Add(targets);
+}
+
+bool MSharedModelInstall::Install(MOvlOutputs outputs, MOutputLog^ log)
+{
+	unsigned int errors = log->GetErrorCount();
+
+	// Every distinct model file, each hashed once
+	List<String^>^ models = gcnew List<String^>();
+	Dictionary<String^, int>^ modelIndex = gcnew Dictionary<String^, int>(StringComparer::OrdinalIgnoreCase);
+	List<List<String^>^>^ sections = gcnew List<List<String^>^>();
+
+	for each (IOvlProject^ project in _projects)
+	{
+		List<String^>^ files = gcnew List<String^>();
+
+		for each (String^ model in project->GetSectionModels())
+		{
+			if (String::IsNullOrWhiteSpace(model))
+				continue;
+
+			String^ full = Path::GetFullPath(model);
+			files->Add(full);
+
+			if (!modelIndex->ContainsKey(full))
+			{
+				modelIndex[full] = models->Count;
+				models->Add(full);
+			}
+		}
+
+		sections->Add(files);
+	}
+
+	std::vector<std::vector<std::string>> groups;
+
+	for each (String^ model in models)
+	{
+		std::vector<std::string> group;
+		group.push_back(util::std_string(model));
+		group.push_back(util::std_string(model->Replace("common.ovl", "unique.ovl")));
+		groups.push_back(group);
+	}
+
+	std::vector<unsigned long long> hashes;
+	std::vector<std::string> hashErrors;
+
+	HashFiles(groups, hashes, hashErrors);
+
+	for (size_t i = 0; i < hashErrors.size(); i++)
+	{
+		if (!hashErrors[i].empty())
+			log->Error(marshal_as<String^>(hashErrors[i]));
+	}
+
+	if (log->GetErrorCount() != errors)
+		return false;
+
+	// Equal hashes are confirmed byte for byte, a collision gets its own key.
+	// Copies under another name get their own key too, the stored file and
+	// its svd symbol are named after the model.
+	Dictionary<unsigned long long, List<int>^>^ buckets = gcnew Dictionary<unsigned long long, List<int>^>();
+	array<String^>^ keys = gcnew array<String^>(models->Count);
+	List<int>^ stored = gcnew List<int>();
+
+	BytesSaved = 0;
+
+	for (int i = 0; i < models->Count; i++)
+	{
+		List<int>^ bucket;
+
+		if (!buckets->TryGetValue(hashes[i], bucket))
+		{
+			bucket = gcnew List<int>();
+			buckets[hashes[i]] = bucket;
+		}
+
+		String^ unique = models[i]->Replace("common.ovl", "unique.ovl");
+
+		for each (int other in bucket)
+		{
+			if (String::Equals(util::GetOvlName(models[i]), util::GetOvlName(models[other]), StringComparison::OrdinalIgnoreCase) &&
+				util::SameFileContents(models[i], models[other]) &&
+				util::SameFileContents(unique, models[other]->Replace("common.ovl", "unique.ovl")))
+			{
+				keys[i] = keys[other];
+				BytesSaved += (gcnew FileInfo(models[i]))->Length + (gcnew FileInfo(unique))->Length;
+				break;
+			}
+		}
+
+		if (keys[i] == nullptr)
+		{
+			keys[i] = bucket->Count ? String::Format("{0:x16}-{1}", hashes[i], bucket->Count) : String::Format("{0:x16}", hashes[i]);
+			bucket->Add(i);
+			stored->Add(i);
+		}
+	}
+
+	ModelsReferenced = 0;
+	ModelsStored = stored->Count;
+
+	MStagedInstall^ install = gcnew MStagedInstall();
+
+	try
+	{
+		if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+		{
+			for each (int i in stored)
+				Store(models[i], keys[i], install);
+		}
+
+		for (int p = 0; p < _projects->Count; p++)
+		{
+			IOvlProject^ project = _projects[p];
+			MBuildTargets^ staged = install->StageTargets(_targets[p]);
+
+			HashSet<String^>^ shared = gcnew HashSet<String^>(StringComparer::OrdinalIgnoreCase);
+
+			// The project's own overrides, put back once it is built
+			Dictionary<String^, String^>^ previous = gcnew Dictionary<String^, String^>(project->ModelOvlPaths);
+
+			try
+			{
+				for each (String^ model in sections[p])
+				{
+					String^ key = keys[modelIndex[model]];
+					String^ name = util::GetOvlName(model);
+
+					project->ModelOvlPaths[name] = StoreOvlPath + key + "\\" + name;
+
+					shared->Add(model);
+					shared->Add(model->Replace("common.ovl", "unique.ovl"));
+					ModelsReferenced++;
+				}
+
+				project->Build(outputs & ~MOvlOutputs::Models, staged, log);
+
+				// Whatever else the project copies goes to its own directory
+				if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None)
+				{
+					for each (String^ file in project->GetInputs(MOvlOutputs::Models))
+					{
+						if (!String::IsNullOrWhiteSpace(file) && !shared->Contains(Path::GetFullPath(file)))
+							File::Copy(file, staged->ModelDirectory + Path::GetFileName(file), true);
+					}
+				}
+			}
+			finally
+			{
+				for each (String^ model in sections[p])
+				{
+					String^ name = util::GetOvlName(model);
+					String^ path;
+
+					if (previous->TryGetValue(name, path))
+						project->ModelOvlPaths[name] = path;
+					else
+						project->ModelOvlPaths->Remove(name);
+				}
+			}
+		}
+
+		if (log->GetErrorCount() != errors)
+		{
+			log->Error("Build failed, nothing was installed.");
+			return false;
+		}
+
+		install->Commit();
+	}
+	catch (Exception^ e)
+	{
+		log->Error(String::Format("Install failed: {0}", e->Message));
+		return false;
+	}
+	finally
+	{
+		delete install;
+	}
+
+	log->Info(String::Format("{0} section models installed as {1} shared models, {2:N0} bytes saved.",
+		ModelsReferenced, ModelsStored, BytesSaved));
+
+	return true;
+}
+
+#pragma endregion
@@ -0,0 +1,68 @@
+// MSharedModelInstall.hpp
+// Installs several projects, storing byte-identical section models once
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+#include "MStagedInstall.hpp"
+
+namespace R3ALInterop
+{
+
+	// Section models of every added project are hashed (common and unique
+	// OVL together) and each distinct model is stored once, in
+	// "<StoreDirectory>\<hash>\<model>.common.ovl". Only models with the
+	// same name are shared, since the name is both the stored file name and
+	// the "<model>:svd" symbol the stub refers to. Stubs are built with
+	// ModelOvlPaths pointing their sids at the stored copy instead of the
+	// project's own directory. Models already in the store from an earlier
+	// install are reused. Other model OVLs (such as MPath::Shared) are
+	// copied to each project's ModelDirectory as usual. ModelOvlPaths
+	// entries the project already had are restored after its build.
+	public ref class MSharedModelInstall
+	{
+	private:
+		List<IOvlProject^>^ _projects;
+		List<MBuildTargets^>^ _targets;
+
+		// Stores one model, unless an identical copy is already there.
+		void Store(String^ model, String^ key, MStagedInstall^ install);
+
+	public:
+		property String^ StoreDirectory;  // Where the distinct models are written
+		property String^ StoreOvlPath;    // StoreDirectory relative to the game directory, e.g. "Path\Shared\"
+
+		property int ModelsReferenced;    // Section models of all projects, set by Install
+		property int ModelsStored;        // Distinct models among them
+		property long long BytesSaved;    // Size of the copies that were not installed
+
+		// Constructor.
+		MSharedModelInstall(String^ storeDirectory, String^ storeOvlPath);
+
+		// Adds a project to install into `targets`.
+		void Add(IOvlProject^ project, MBuildTargets^ targets);
+
+		// Builds and installs `outputs` of every project through one
+		// MStagedInstall, nothing is installed if anything fails.
+		//     * Registers errors to the MOutputLog, returns false on failure
+		bool Install(MOvlOutputs outputs, MOutputLog^ log);
+
+	};
+
+}
@@ -0,0 +1,390 @@
+// MStagedInstall.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+// Windows.h has to come before the managed namespaces are opened
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#include "MStagedInstall.hpp"
+
+using namespace R3ALInterop;
+using namespace System::Threading;
+
+namespace
+{
+
+	bool FlushPath(const std::wstring& path)
+	{
+		HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+
+		if (handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		BOOL flushed = FlushFileBuffers(handle);
+		CloseHandle(handle);
+
+		return flushed != FALSE;
+	}
+
+}
+
+namespace R3ALInterop
+{
+
+	// Body of the parallel per-file flush.
+	private ref class FileFlusher
+	{
+	private:
+		List<String^>^ _files;
+		array<bool>^ _flushed;
+
+	public:
+		FileFlusher(List<String^>^ files, array<bool>^ flushed)
+			: _files(files), _flushed(flushed)
+		{
+		}
+
+		void Run(int index)
+		{
+			_flushed[index] = FlushPath(marshal_as<std::wstring>(_files[index]));
+		}
+	};
+
+}
+
+#pragma region MStagedInstall
+
+MStagedInstall::MStagedInstall()
+	: _id(String::Format("{0}-{1}", Diagnostics::Process::GetCurrentProcess()->Id, Guid::NewGuid().ToString("N"))), _staging(gcnew Dictionary<String^, String^>(StringComparer::OrdinalIgnoreCase)), _finished(false)
+{
+	FlushToDisk = true;
+}
+
+MStagedInstall::~MStagedInstall()
+{
+	if (!_finished)
+		Rollback();
+}
+
+String^ MStagedInstall::StageDirectory(String^ finalDirectory)
+{
+	String^ directory = Path::GetFullPath(finalDirectory)->TrimEnd(Path::DirectorySeparatorChar);
+	String^ staging;
+
+	if (!_staging->TryGetValue(directory, staging))
+	{
+		staging = Path::Combine(directory, StagingPrefix + _id);
+
+		// Registered under the lock, so a concurrent Recover never sees it
+		// unregistered
+		Monitor::Enter(ActiveLock);
+		try
+		{
+			Recover(directory);
+
+			DirectoryInfo^ info = Directory::CreateDirectory(staging);
+			info->Attributes = info->Attributes | FileAttributes::Hidden;
+
+			Active->Add(staging);
+		}
+		finally
+		{
+			Monitor::Exit(ActiveLock);
+		}
+
+		_staging[directory] = staging;
+	}
+
+	return staging + Path::DirectorySeparatorChar;
+}
+
+String^ MStagedInstall::Stage(String^ finalPath)
+{
+	return StageDirectory(Path::GetDirectoryName(Path::GetFullPath(finalPath))) + Path::GetFileName(finalPath);
+}
+
+MBuildTargets^ MStagedInstall::StageTargets(MBuildTargets^ targets)
+{
+	MBuildTargets^ staged = gcnew MBuildTargets();
+
+	staged->TextureOVL = String::IsNullOrWhiteSpace(targets->TextureOVL) ? targets->TextureOVL : Stage(targets->TextureOVL);
+	staged->IconOVL = String::IsNullOrWhiteSpace(targets->IconOVL) ? targets->IconOVL : Stage(targets->IconOVL);
+	staged->StubOVL = String::IsNullOrWhiteSpace(targets->StubOVL) ? targets->StubOVL : Stage(targets->StubOVL);
+	staged->BlankOVL = String::IsNullOrWhiteSpace(targets->BlankOVL) ? targets->BlankOVL : Stage(targets->BlankOVL);
+	staged->ModelDirectory = String::IsNullOrWhiteSpace(targets->ModelDirectory) ? targets->ModelDirectory : StageDirectory(targets->ModelDirectory);
+
+	return staged;
+}
+
+void MStagedInstall::Commit()
+{
+	if (_finished)
+		throw gcnew InvalidOperationException("This install has already been committed or rolled back.");
+
+	List<String^>^ files = gcnew List<String^>();
+
+	for each (String^ staging in _staging->Values)
+		files->AddRange(Directory::GetFiles(staging));
+
+	if (FlushToDisk)
+		Flush(files);
+
+	// From here on the staged files are complete on disk
+	List<String^>^ markers = gcnew List<String^>();
+
+	for each (String^ staging in _staging->Values)
+	{
+		String^ marker = Path::Combine(staging, CommitMarker);
+		File::WriteAllText(marker, _id);
+		markers->Add(marker);
+	}
+
+	if (FlushToDisk)
+		Flush(markers);
+
+	// Past this point Recover completes the install, so never roll back
+	_finished = true;
+
+	List<String^>^ pending = gcnew List<String^>();
+	Exception^ failure = nullptr;
+
+	try
+	{
+		for each (KeyValuePair<String^, String^> pair in _staging)
+		{
+			try
+			{
+				MoveInto(pair.Value, pair.Key);
+			}
+			catch (Exception^ e)
+			{
+				pending->Add(pair.Key);
+				failure = e;
+			}
+		}
+	}
+	finally
+	{
+		// Unregistered even on failure, so Recover can pick them up
+		Monitor::Enter(ActiveLock);
+		try
+		{
+			for each (String^ staging in _staging->Values)
+				Active->Remove(staging);
+		}
+		finally
+		{
+			Monitor::Exit(ActiveLock);
+		}
+	}
+
+	if (pending->Count == 0)
+		return;
+
+	// A replaced file may have been open for a moment, retry once
+	List<String^>^ failed = gcnew List<String^>();
+
+	for each (String^ directory in pending)
+	{
+		try
+		{
+			Recover(directory);
+		}
+		catch (Exception^ e)
+		{
+			failed->Add(directory);
+			failure = e;
+		}
+	}
+
+	if (failed->Count > 0)
+	{
+		throw gcnew IOException(String::Format("Install partly done: {0} of {1} directories were updated, the rest of the files "
+			"stay staged under \"{2}\" and are moved by the next install there. {3}", _staging->Count - failed->Count,
+			_staging->Count, String::Join("\", \"", failed), failure->Message), failure);
+	}
+}
+
+void MStagedInstall::Rollback()
+{
+	Monitor::Enter(ActiveLock);
+	try
+	{
+		for each (String^ staging in _staging->Values)
+		{
+			if (Directory::Exists(staging))
+				Directory::Delete(staging, true);
+
+			Active->Remove(staging);
+		}
+	}
+	finally
+	{
+		Monitor::Exit(ActiveLock);
+	}
+
+	_staging->Clear();
+	_finished = true;
+}
+
+void MStagedInstall::Flush(List<String^>^ files)
+{
+	// A volume handle flushes everything on it in one call, but needs
+	// administrator rights. Otherwise flush the files, in parallel so the
+	// waits overlap.
+	HashSet<String^>^ volumes = gcnew HashSet<String^>(StringComparer::OrdinalIgnoreCase);
+
+	for each (String^ file in files)
+		volumes->Add(Path::GetPathRoot(file));
+
+	bool flushedAll = true;
+
+	for each (String^ volume in volumes)
+	{
+		if (volume->Length < 2 || volume[1] != ':' ||
+			!FlushPath(marshal_as<std::wstring>("\\\\.\\" + volume->Substring(0, 2))))
+		{
+			flushedAll = false;
+			break;
+		}
+	}
+
+	if (flushedAll)
+		return;
+
+	array<bool>^ flushed = gcnew array<bool>(files->Count);
+
+	Threading::Tasks::Parallel::For(0, files->Count, gcnew Action<int>(gcnew FileFlusher(files, flushed), &FileFlusher::Run));
+
+	for (int i = 0; i < files->Count; i++)
+	{
+		if (!flushed[i])
+			throw gcnew IOException(String::Format("Failed to flush \"{0}\" to disk.", files[i]));
+	}
+}
+
+void MStagedInstall::MoveInto(String^ staging, String^ directory)
+{
+	for each (String^ file in Directory::GetFiles(staging))
+	{
+		if (Path::GetFileName(file)->Equals(CommitMarker, StringComparison::OrdinalIgnoreCase))
+			continue;
+
+		std::wstring source = marshal_as<std::wstring>(file);
+		std::wstring destination = marshal_as<std::wstring>(Path::Combine(directory, Path::GetFileName(file)));
+
+		if (!MoveFileExW(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING))
+			throw gcnew IOException(String::Format("Failed to install \"{0}\" (error {1}).", file, static_cast<unsigned int>(GetLastError())));
+	}
+
+	Directory::Delete(staging, true);
+}
+
+void MStagedInstall::Recover(String^ directory)
+{
+	if (!Directory::Exists(directory))
+		return;
+
+	Monitor::Enter(ActiveLock);
+	try
+	{
+		for each (String^ staging in Directory::GetDirectories(directory, StagingPrefix + "*"))
+		{
+			if (Active->Contains(staging) || OwnedByOtherProcess(staging))
+				continue;
+
+			if (File::Exists(Path::Combine(staging, CommitMarker)))
+				MoveInto(staging, directory);
+			else
+				Directory::Delete(staging, true);
+		}
+	}
+	finally
+	{
+		Monitor::Exit(ActiveLock);
+	}
+}
+
+bool MStagedInstall::OwnedByOtherProcess(String^ staging)
+{
+	// Directories from before the process id was part of the name have no
+	// owner left
+	String^ id = Path::GetFileName(staging)->Substring(StagingPrefix->Length);
+	int split = id->IndexOf('-');
+	int process;
+
+	if (split < 0 || !Int32::TryParse(id->Substring(0, split), process) || process == Diagnostics::Process::GetCurrentProcess()->Id)
+		return false;
+
+	try
+	{
+		Diagnostics::Process::GetProcessById(process);
+		return true;
+	}
+	catch (ArgumentException^)
+	{
+		// Not running
+		return false;
+	}
+}
+
+bool MStagedInstall::Install(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log)
+{
+	return Install(project, outputs, targets, log, nullptr);
+}
+
+bool MStagedInstall::Install(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log, MOutputCache^ cache)
+{
+	unsigned int errors = log->GetErrorCount();
+	MStagedInstall^ install = gcnew MStagedInstall();
+
+	// Checked against the final directory, the staging one is always empty
+	if ((outputs & MOvlOutputs::Models) != MOvlOutputs::None && ProfileSettings::CanReuseModels(project, targets->ModelDirectory))
+	{
+		log->Info("Draft build: model OVLs are already installed, not copying them.");
+		outputs = outputs & ~MOvlOutputs::Models;
+	}
+
+	try
+	{
+		if (cache != nullptr)
+			cache->Build(project, outputs, install->StageTargets(targets), log);
+		else
+			project->Build(outputs, install->StageTargets(targets), log);
+
+		if (log->GetErrorCount() != errors)
+		{
+			log->Error("Build failed, nothing was installed.");
+			return false;
+		}
+
+		install->Commit();
+	}
+	catch (Exception^ e)
+	{
+		log->Error(String::Format("Install failed: {0}", e->Message));
+		return false;
+	}
+	finally
+	{
+		delete install;
+	}
+
+	return true;
+}
+
+#pragma endregion
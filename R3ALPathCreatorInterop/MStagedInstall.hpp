@@ -0,0 +1,110 @@
+// MStagedInstall.hpp
+// Builds outputs into staging directories and moves them into place together
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+#include "OvlProject.hpp"
+#include "MOutputCache.hpp"
+
+namespace R3ALInterop
+{
+
+	// Outputs are written to a hidden ".staging-<id>" directory inside each
+	// target directory, so they are on the same volume as their final
+	// location. Commit flushes every staged file in one pass, then renames
+	// each into place, replacing the old file atomically. Readers only ever
+	// see the old or the new OVL, never a partly written one.
+	//
+	// A ".commit" marker is written to each staging directory once its files
+	// are flushed. If the process dies while renaming, Recover finishes the
+	// moves of marked directories and deletes unmarked ones. It runs before
+	// anything is staged into a directory, so every installer recovers.
+	//
+	// Only Install and Stage*/Commit are atomic. The projects' Create*OVL and
+	// CopyFilesTo write straight to the path they are given: they are what
+	// Install points at its staging directories, so staging inside them
+	// would stage every output twice. Anything a running game may read
+	// should be written through Install.
+	public ref class MStagedInstall
+	{
+	private:
+		String^ _id;
+		Dictionary<String^, String^>^ _staging;  // Final directory -> staging directory
+		bool _finished;
+
+		static initonly String^ StagingPrefix = ".staging-";  // Followed by <process id>-<guid>
+		static initonly String^ CommitMarker = ".commit";
+
+		static initonly HashSet<String^>^ Active = gcnew HashSet<String^>(StringComparer::OrdinalIgnoreCase);  // Staging directories of this process
+		static initonly Object^ ActiveLock = gcnew Object();  // Guards Active, held while staging directories are created or recovered
+
+		// True if the staging directory belongs to another running process.
+		static bool OwnedByOtherProcess(String^ staging);
+
+		// Flushes the files to disk, one flush per volume when allowed.
+		static void Flush(List<String^>^ files);
+
+		// Moves every file of a staging directory into `directory`.
+		static void MoveInto(String^ staging, String^ directory);
+
+	public:
+		property bool FlushToDisk; // true by default
+
+		// Constructor.
+		MStagedInstall();
+
+		// Dispose, rolls back unless committed.
+		~MStagedInstall();
+
+		// Returns the path to write a file meant for `finalPath` to.
+		String^ Stage(String^ finalPath);
+
+		// Returns the staging directory (ending with a separator) for files
+		// meant for `finalDirectory`.
+		String^ StageDirectory(String^ finalDirectory);
+
+		// Returns a copy of `targets` pointing into the staging directories.
+		MBuildTargets^ StageTargets(MBuildTargets^ targets);
+
+		// Moves every staged file into place. A directory that fails to move
+		// is retried once through Recover. If it still fails the exception
+		// names the directories left staged; their files are complete and are
+		// moved by the next Recover of that directory.
+		//     * Throws System::Exception-inherited classes
+		void Commit();
+
+		// Deletes every staged file.
+		void Rollback();
+
+		// Finishes or discards installs interrupted in `directory`. Installs
+		// still running in this or another process are left alone.
+		//     * Throws System::Exception-inherited classes
+		static void Recover(String^ directory);
+
+		// Builds `outputs` through staging and installs them only if no error
+		// was logged.
+		//     * Registers errors to the MOutputLog, returns false on failure
+		static bool Install(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log);
+
+		// Same, building through `cache` (may be null).
+		static bool Install(IOvlProject^ project, MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log, MOutputCache^ cache);
+
+	};
+
+}
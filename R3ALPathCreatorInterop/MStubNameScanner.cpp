@@ -0,0 +1,221 @@
+// MStubNameScanner.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "MStubNameScanner.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region Private
+
+MStubScanResult^ MStubNameScanner::Convert(String^ stubFile, const StubSummary& stub, String^ modelDirectory)
+{
+	if (stub.Kind == StubKind::Unknown)
+		return nullptr;
+
+	MStubScanResult^ result = gcnew MStubScanResult();
+	result->StubFile = stubFile;
+
+	String^ imageDirectory = Path::GetDirectoryName(Path::GetFullPath(stubFile));
+
+	if (String::IsNullOrEmpty(modelDirectory))
+		modelDirectory = imageDirectory;
+
+	if (stub.Kind == StubKind::Path)
+		result->Project = ConvertPath(stub, modelDirectory, imageDirectory, result->Warnings);
+	else
+		result->Project = ConvertQueue(stub, modelDirectory, imageDirectory, result->Warnings);
+
+	if (stub.Text.empty())
+		result->Warnings->Add("No in-game name found, the project name is used.");
+
+	for (const std::string& field : stub.Unrecovered)
+		result->Warnings->Add(marshal_as<String^>(field) + " could not be read from the stub and keeps its default, check it before building.");
+
+	return result;
+}
+
+MPath^ MStubNameScanner::ConvertPath(const StubSummary& stub, String^ modelDirectory, String^ imageDirectory, List<String^>^ warnings)
+{
+	MPath^ path = gcnew MPath();
+	path->Name = marshal_as<String^>(stub.Name);
+	path->IngameName = stub.Text.empty() ? path->Name : marshal_as<String^>(stub.Text);
+
+	for (const std::string& section : stub.Sections)
+	{
+		String^ model = marshal_as<String^>(section);
+		MSectionInfo^ info = MSectionSchema::FindPathRole(marshal_as<String^>(ModelRole(section)));
+
+		if (info == nullptr)
+		{
+			warnings->Add("Section \"" + model + "\" does not follow the model naming scheme.");
+			continue;
+		}
+
+		path->SetSection(info->Index, MPathSection(FindModel(modelDirectory, model, warnings)));
+
+		if (info->Set == MSectionSet::Extended)
+			path->IsExtended = true;
+	}
+
+	for each (MSectionInfo^ info in MSectionSchema::PathSections)
+	{
+		if (info->Required && String::IsNullOrEmpty(path->GetSection(info->Index).Section))
+			warnings->Add("No model found for required section " + info->Role + ".");
+	}
+
+	if (stub.Textures.size() != 2)
+		warnings->Add(String::Format("Expected 2 textures, found {0}.", static_cast<int>(stub.Textures.size())));
+
+	if (stub.Textures.size() > 0)
+		path->TextureA = FindImage(imageDirectory, marshal_as<String^>(stub.Textures[0]));
+
+	if (stub.Textures.size() > 1)
+		path->TextureB = FindImage(imageDirectory, marshal_as<String^>(stub.Textures[1]));
+
+	path->Icon = FindImage(imageDirectory, path->Name + "_Icon");
+
+	if (String::IsNullOrEmpty(path->TextureA) || String::IsNullOrEmpty(path->TextureB))
+		warnings->Add("Texture source images not found, set TextureA and TextureB before building.");
+
+	if (String::IsNullOrEmpty(path->Icon))
+		warnings->Add("Icon source image not found, set Icon before building.");
+
+	return path;
+}
+
+MQueue^ MStubNameScanner::ConvertQueue(const StubSummary& stub, String^ modelDirectory, String^ imageDirectory, List<String^>^ warnings)
+{
+	MQueue^ queue = gcnew MQueue();
+	queue->Name = marshal_as<String^>(stub.Name);
+	queue->IngameName = stub.Text.empty() ? queue->Name : marshal_as<String^>(stub.Text);
+
+	for (const std::string& section : stub.Sections)
+	{
+		String^ model = marshal_as<String^>(section);
+		MSectionInfo^ info = MSectionSchema::FindQueueRole(marshal_as<String^>(ModelRole(section)));
+
+		if (info == nullptr)
+		{
+			warnings->Add("Section \"" + model + "\" does not follow the model naming scheme.");
+			continue;
+		}
+
+		int index = info->Index;
+
+		// The stub lists SlopeStraight2 after SlopeStraight1, both with the same role
+		if (index == static_cast<int>(QueueSectionId::SlopeStraight1) && !String::IsNullOrEmpty(queue->SlopeStraight1))
+			index = static_cast<int>(QueueSectionId::SlopeStraight2);
+
+		queue->SetSection(index, FindModel(modelDirectory, model, warnings));
+	}
+
+	if (String::IsNullOrEmpty(queue->SlopeStraight2))
+		queue->SlopeStraight2 = queue->SlopeStraight1;
+
+	if (stub.Textures.empty())
+		warnings->Add("No texture found.");
+	else
+		queue->Texture = FindImage(imageDirectory, marshal_as<String^>(stub.Textures[0]));
+
+	queue->Icon = FindImage(imageDirectory, queue->Name + "_Icon");
+
+	if (String::IsNullOrEmpty(queue->Texture))
+		warnings->Add("Texture source image not found, set Texture before building.");
+
+	if (String::IsNullOrEmpty(queue->Icon))
+		warnings->Add("Icon source image not found, set Icon before building.");
+
+	return queue;
+}
+
+String^ MStubNameScanner::FindModel(String^ modelDirectory, String^ section, List<String^>^ warnings)
+{
+	String^ file = Path::Combine(modelDirectory, section + ".common.ovl");
+
+	if (!File::Exists(file))
+		warnings->Add("Model OVL not found: " + file);
+
+	return file;
+}
+
+String^ MStubNameScanner::FindImage(String^ directory, String^ name)
+{
+	for each (String^ extension in ImageExtensions)
+	{
+		String^ file = Path::Combine(directory, name + extension);
+
+		if (File::Exists(file))
+			return file;
+	}
+
+	return "";
+}
+
+#pragma endregion
+
+#pragma region Public
+
+MStubScanResult^ MStubNameScanner::Scan(String^ stubFile, String^ modelDirectory)
+{
+	StubSummary stub;
+	std::string error;
+
+	if (!ScanStubOvl(util::std_string(stubFile), stub, error))
+		throw gcnew IOException(marshal_as<String^>(error));
+
+	return Convert(stubFile, stub, modelDirectory);
+}
+
+List<MStubScanResult^>^ MStubNameScanner::ScanDirectory(String^ directory, bool recursive)
+{
+	array<String^>^ files = Directory::GetFiles(directory, "*.common.ovl",
+		recursive ? SearchOption::AllDirectories : SearchOption::TopDirectoryOnly);
+
+	std::vector<std::string> names;
+	names.reserve(files->Length);
+
+	for each (String^ file in files)
+		names.push_back(util::std_string(file));
+
+	std::vector<StubSummary> stubs;
+	std::vector<std::string> errors;
+
+	// Model OVLs are scanned too, they come back as StubKind::Unknown
+	ScanStubOvls(names, stubs, errors);
+
+	List<MStubScanResult^>^ results = gcnew List<MStubScanResult^>();
+
+	for (int i = 0; i < files->Length; i++)
+	{
+		if (!errors[i].empty())
+		{
+			MStubScanResult^ failed = gcnew MStubScanResult();
+			failed->StubFile = files[i];
+			failed->Warnings->Add(marshal_as<String^>(errors[i]));
+			results->Add(failed);
+			continue;
+		}
+
+		MStubScanResult^ result = Convert(files[i], stubs[i], nullptr);
+
+		if (result != nullptr)
+			results->Add(result);
+	}
+
+	return results;
+}
+
+#pragma endregion
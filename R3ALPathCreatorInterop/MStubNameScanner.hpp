@@ -0,0 +1,83 @@
+// MStubNameScanner.hpp
+// Drafts MPath and MQueue projects from the names found in stub OVLs
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "OvlProject.hpp"
+#include "StubNameScan.hpp"
+#include "MPath.hpp"
+#include "MQueue.hpp"
+#include "MSectionSchema.hpp"
+
+namespace R3ALInterop
+{
+
+	// A project drafted from the names in a stub OVL.
+	public ref class MStubScanResult
+	{
+	public:
+		property String^ StubFile;
+		property IOvlProject^ Project;     // MPath or MQueue
+		property List<String^>^ Warnings;  // Anything that has to be filled in by hand
+
+		// Constructor.
+		MStubScanResult()
+		{
+			Warnings = gcnew List<String^>();
+		}
+	};
+
+	// Drafts path and queue projects from a best-effort name scan of their
+	// stub OVLs (see ScanStubOvl). This is not an OVL importer: only names
+	// are recovered. Sections are matched to model OVLs by name, the same way
+	// OvlModelSearcher does. Texture sources are looked up as image files
+	// named after the textures. Fields the scan cannot recover keep their
+	// defaults and are reported as warnings.
+	public ref class MStubNameScanner
+	{
+	private:
+
+		static initonly array<String^>^ ImageExtensions = { ".png", ".bmp", ".jpg", ".jpeg", ".tga", ".tif", ".tiff", ".gif" };
+
+		static MStubScanResult^ Convert(String^ stubFile, const StubSummary& stub, String^ modelDirectory);
+
+		static MPath^ ConvertPath(const StubSummary& stub, String^ modelDirectory, String^ imageDirectory, List<String^>^ warnings);
+		static MQueue^ ConvertQueue(const StubSummary& stub, String^ modelDirectory, String^ imageDirectory, List<String^>^ warnings);
+
+		// Returns the model OVL for a section, warning if it does not exist.
+		static String^ FindModel(String^ modelDirectory, String^ section, List<String^>^ warnings);
+
+		// Returns the image file named `name` in `directory`, or "".
+		static String^ FindImage(String^ directory, String^ name);
+
+	public:
+
+		// Scans one stub. `stubFile` is the common OVL, `modelDirectory`
+		// holds the model OVLs (null = the stub's directory).
+		//     * Throws System::Exception-inherited classes, or returns null
+		//       if the file is not a path or queue stub
+		static MStubScanResult^ Scan(String^ stubFile, String^ modelDirectory);
+
+		// Scans every stub OVL in `directory`, reading the files in
+		// parallel. Models are looked up next to each stub. Files that cannot
+		// be read are returned with a warning and no project.
+		static List<MStubScanResult^>^ ScanDirectory(String^ directory, bool recursive);
+
+	};
+
+}
@@ -0,0 +1,232 @@
+// Metrics.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "Metrics.hpp"
+
+using namespace R3ALInterop;
+
+namespace
+{
+
+	const size_t CounterCount = static_cast<size_t>(Counter::Count);
+	const size_t StageCount = static_cast<size_t>(Stage::Count);
+
+	void ClearHistogram(HistogramSnapshot& histogram)
+	{
+		std::memset(&histogram, 0, sizeof(histogram));
+	}
+
+	struct MetricsRegistry
+	{
+		std::mutex Lock;
+		std::unordered_map<const RCT3Debugging::OutputLog*, std::shared_ptr<BuildMetrics>> Metrics;
+		std::shared_ptr<BuildMetrics> Sink;
+
+		MetricsRegistry()
+			: Sink(std::make_shared<BuildMetrics>())
+		{
+		}
+	};
+
+	MetricsRegistry& Registry()
+	{
+		static MetricsRegistry registry;
+
+		return registry;
+	}
+
+	long long Now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+}
+
+struct BuildMetrics::Impl
+{
+	std::atomic<unsigned long long> Counters[CounterCount];
+
+	mutable std::mutex Lock;  // Guards Stages
+	HistogramSnapshot Stages[StageCount];
+
+	Impl()
+	{
+		for (auto& counter : Counters)
+			counter = 0;
+
+		for (auto& stage : Stages)
+			ClearHistogram(stage);
+	}
+};
+
+#pragma region BuildMetrics
+
+BuildMetrics::BuildMetrics()
+	: _impl(new Impl())
+{
+}
+
+BuildMetrics::~BuildMetrics()
+{
+	delete _impl;
+}
+
+void BuildMetrics::Add(Counter counter, unsigned long long amount)
+{
+	_impl->Counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void BuildMetrics::Record(Stage stage, double milliseconds)
+{
+	unsigned long long micros = static_cast<unsigned long long>(milliseconds * 1000.0);
+	unsigned int bucket = 0;
+
+	while (bucket + 1 < HistogramBuckets && micros >= (1ull << bucket))
+		bucket++;
+
+	std::lock_guard<std::mutex> guard(_impl->Lock);
+	HistogramSnapshot& histogram = _impl->Stages[static_cast<size_t>(stage)];
+
+	histogram.Min = histogram.Count ? std::min(histogram.Min, milliseconds) : milliseconds;
+	histogram.Max = histogram.Count ? std::max(histogram.Max, milliseconds) : milliseconds;
+	histogram.Count++;
+	histogram.Sum += milliseconds;
+	histogram.Buckets[bucket]++;
+}
+
+MetricsSnapshot BuildMetrics::Snapshot() const
+{
+	MetricsSnapshot snapshot;
+
+	for (size_t i = 0; i < CounterCount; i++)
+		snapshot.Counters[i] = _impl->Counters[i].load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> guard(_impl->Lock);
+
+	for (size_t i = 0; i < StageCount; i++)
+		snapshot.Stages[i] = _impl->Stages[i];
+
+	return snapshot;
+}
+
+MetricsSnapshot BuildMetrics::SnapshotAndReset()
+{
+	MetricsSnapshot snapshot;
+
+	for (size_t i = 0; i < CounterCount; i++)
+		snapshot.Counters[i] = _impl->Counters[i].exchange(0, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> guard(_impl->Lock);
+
+	for (size_t i = 0; i < StageCount; i++)
+	{
+		snapshot.Stages[i] = _impl->Stages[i];
+		ClearHistogram(_impl->Stages[i]);
+	}
+
+	return snapshot;
+}
+
+#pragma endregion
+
+#pragma region StageTimer
+
+StageTimer::StageTimer(std::shared_ptr<BuildMetrics> metrics, Stage stage)
+	: _metrics(std::move(metrics)), _stage(stage), _start(Now())
+{
+}
+
+StageTimer::~StageTimer()
+{
+	_metrics->Record(_stage, (Now() - _start) / 1000.0);
+}
+
+#pragma endregion
+
+#pragma region Functions
+
+const char* R3ALInterop::CounterName(Counter counter)
+{
+	switch (counter)
+	{
+	case Counter::BytesDecoded:
+		return "bytesDecoded";
+	case Counter::BlocksLoaded:
+		return "blocksLoaded";
+	case Counter::OvlBytesWritten:
+		return "ovlBytesWritten";
+	case Counter::FilesCopied:
+		return "filesCopied";
+	case Counter::BytesCopied:
+		return "bytesCopied";
+	default:
+		return "unknown";
+	}
+}
+
+const char* R3ALInterop::StageName(Stage stage)
+{
+	switch (stage)
+	{
+	case Stage::Decode:
+		return "decode";
+	case Stage::Resample:
+		return "resample";
+	case Stage::TextureLoad:
+		return "textureLoad";
+	case Stage::OvlSave:
+		return "ovlSave";
+	case Stage::Copy:
+		return "copy";
+	default:
+		return "unknown";
+	}
+}
+
+void R3ALInterop::RegisterMetrics(const RCT3Debugging::OutputLog& log, const std::shared_ptr<BuildMetrics>& metrics)
+{
+	MetricsRegistry& registry = Registry();
+	std::lock_guard<std::mutex> guard(registry.Lock);
+
+	registry.Metrics[&log] = metrics;
+}
+
+void R3ALInterop::UnregisterMetrics(const RCT3Debugging::OutputLog& log)
+{
+	MetricsRegistry& registry = Registry();
+	std::lock_guard<std::mutex> guard(registry.Lock);
+
+	registry.Metrics.erase(&log);
+}
+
+std::shared_ptr<BuildMetrics> R3ALInterop::MetricsFor(const RCT3Debugging::OutputLog& log)
+{
+	MetricsRegistry& registry = Registry();
+	std::lock_guard<std::mutex> guard(registry.Lock);
+
+	auto found = registry.Metrics.find(&log);
+
+	return found != registry.Metrics.end() ? found->second : registry.Sink;
+}
+
+#pragma endregion
@@ -0,0 +1,119 @@
+// Metrics.hpp
+// Counters and latency histograms collected during a build
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include <memory>
+
+#include <OutputLog.hpp>
+
+namespace R3ALInterop
+{
+
+	enum class Counter
+	{
+		BytesDecoded,      // RGBA bytes produced by image decoding
+		BlocksLoaded,      // 4x4 blocks of the textures handed to the OVLs
+		OvlBytesWritten,
+		FilesCopied,
+		BytesCopied,
+		Count
+	};
+
+	enum class Stage
+	{
+		Decode,
+		Resample,
+		TextureLoad,  // Loading a texture into the asset library
+		OvlSave,      // Includes DXT compression, which the library does on save
+		Copy,
+		Count
+	};
+
+	// Bucket i counts samples below 2^i microseconds, the last one the rest.
+	const unsigned int HistogramBuckets = 28;
+
+	struct HistogramSnapshot
+	{
+		unsigned long long Count;
+		double Sum;   // Milliseconds
+		double Min;
+		double Max;
+		unsigned long long Buckets[HistogramBuckets];
+	};
+
+	struct MetricsSnapshot
+	{
+		unsigned long long Counters[static_cast<size_t>(Counter::Count)];
+		HistogramSnapshot Stages[static_cast<size_t>(Stage::Count)];
+	};
+
+	const char* CounterName(Counter counter);
+	const char* StageName(Stage stage);
+
+	// Thread safe, counters are atomic and histograms share one lock.
+	class BuildMetrics
+	{
+	private:
+		struct Impl;
+		Impl* _impl;
+
+		BuildMetrics(const BuildMetrics&) = delete;
+		BuildMetrics& operator=(const BuildMetrics&) = delete;
+
+	public:
+
+		// Constructor.
+		BuildMetrics();
+
+		// Destructor.
+		~BuildMetrics();
+
+		void Add(Counter counter, unsigned long long amount);
+
+		void Record(Stage stage, double milliseconds);
+
+		MetricsSnapshot Snapshot() const;
+
+		// Returns the snapshot the reset discarded.
+		MetricsSnapshot SnapshotAndReset();
+	};
+
+	// Associates metrics with an OutputLog, so code that only has the log can
+	// record into them. MOutputLog registers its own.
+	void RegisterMetrics(const RCT3Debugging::OutputLog& log, const std::shared_ptr<BuildMetrics>& metrics);
+	void UnregisterMetrics(const RCT3Debugging::OutputLog& log);
+
+	// Returns the metrics registered for `log`, or a shared sink that is never
+	// read if there are none. The caller shares ownership, so the metrics
+	// stay valid even if the log is unregistered meanwhile.
+	std::shared_ptr<BuildMetrics> MetricsFor(const RCT3Debugging::OutputLog& log);
+
+	// Records the time from construction to destruction as one sample.
+	class StageTimer
+	{
+	private:
+		std::shared_ptr<BuildMetrics> _metrics;
+		Stage _stage;
+		long long _start;
+
+	public:
+		StageTimer(std::shared_ptr<BuildMetrics> metrics, Stage stage);
+		~StageTimer();
+	};
+
+}
@@ -0,0 +1,177 @@
+// OvlProject.hpp
+// Common interface of the path and queue projects, used by tooling that
+// builds or watches either kind
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "System.hpp"
+#include "MOutputLog.hpp"
+
+namespace R3ALInterop
+{
+
+	// The files a project produces.
+	[Flags]
+	public enum class MOvlOutputs
+	{
+		None = 0,
+		Texture = 1,
+		Icon = 2,
+		Stub = 4,
+		Blank = 8,
+		Models = 16,  // Section model OVLs, copied rather than built
+		All = Texture | Icon | Stub | Blank | Models
+	};
+
+	// What a build is for. Textures are built the same way in both profiles:
+	// RCT3Asset::TexImage exposes no compression or mip options to trade
+	// quality for speed with.
+	public enum class MBuildProfile
+	{
+		Release,  // Default
+		Draft     // For in-game previews: in-game name tagged "(Draft)",
+		          // model OVLs already installed unchanged are not copied again
+	};
+
+	// Where each output of a project is written.
+	public ref class MBuildTargets
+	{
+	public:
+		property String^ TextureOVL;
+		property String^ IconOVL;
+		property String^ StubOVL;
+		property String^ BlankOVL;
+		property String^ ModelDirectory; // Must end with a directory separator, see CopyFilesTo
+
+		// Constructor.
+		MBuildTargets()
+		{
+			TextureOVL = "";
+			IconOVL = "";
+			StubOVL = "";
+			BlankOVL = "";
+			ModelDirectory = "";
+		}
+
+		// Returns the target of a single built output (Texture, Icon, Stub or Blank).
+		//     * Throws System::ArgumentOutOfRangeException for any other output
+		String^ Get(MOvlOutputs output)
+		{
+			switch (output)
+			{
+			case MOvlOutputs::Texture:
+				return TextureOVL;
+			case MOvlOutputs::Icon:
+				return IconOVL;
+			case MOvlOutputs::Stub:
+				return StubOVL;
+			case MOvlOutputs::Blank:
+				return BlankOVL;
+			default:
+				throw gcnew ArgumentOutOfRangeException("output");
+			}
+		}
+
+		// Sets the target of a single built output, see Get.
+		void Set(MOvlOutputs output, String^ path)
+		{
+			switch (output)
+			{
+			case MOvlOutputs::Texture:
+				TextureOVL = path;
+				break;
+			case MOvlOutputs::Icon:
+				IconOVL = path;
+				break;
+			case MOvlOutputs::Stub:
+				StubOVL = path;
+				break;
+			case MOvlOutputs::Blank:
+				BlankOVL = path;
+				break;
+			default:
+				throw gcnew ArgumentOutOfRangeException("output");
+			}
+		}
+	};
+
+	// Implemented by MPath and MQueue.
+	public interface class IOvlProject
+	{
+		// Returns the source files the given outputs are built from.
+		List<String^>^ GetInputs(MOvlOutputs outputs);
+
+		property MBuildProfile Profile
+		{
+			MBuildProfile get();
+			void set(MBuildProfile value);
+		}
+
+		// Returns the common OVL of every section model the stub refers to.
+		List<String^>^ GetSectionModels();
+
+		// True if building `outputs` again from the same inputs and
+		// properties writes the same bytes, see MOutputCache. GoldenTests
+		// checks this for every reference case on each run.
+		bool IsDeterministic(MOvlOutputs outputs);
+
+		// Stub OVL paths (relative to the game directory, without extension)
+		// by model name, see util::GetOvlName. Sections whose model is not
+		// listed are referenced from the project's own directory.
+		property Dictionary<String^, String^>^ ModelOvlPaths
+		{
+			Dictionary<String^, String^>^ get();
+		}
+
+		// Builds the given outputs.
+		//     * Registers errors to the MOutputLog
+		//     * Models: throws System::Exception-inherited classes, see CopyFilesTo
+		void Build(MOvlOutputs outputs, MBuildTargets^ targets, MOutputLog^ log);
+	};
+
+	// What each MBuildProfile means for the builders.
+	private ref class ProfileSettings abstract sealed
+	{
+	public:
+
+		// In-game name written to the stub.
+		static String^ IngameName(MBuildProfile profile, String^ ingameName)
+		{
+			return profile == MBuildProfile::Draft ? ingameName + " (Draft)" : ingameName;
+		}
+
+		// True if a draft build can leave out the Models output: every model
+		// OVL is already in `modelDirectory`, same size and not older.
+		static bool CanReuseModels(IOvlProject^ project, String^ modelDirectory)
+		{
+			if (project->Profile != MBuildProfile::Draft || String::IsNullOrEmpty(modelDirectory))
+				return false;
+
+			for each (String^ file in project->GetInputs(MOvlOutputs::Models))
+			{
+				FileInfo^ source = gcnew FileInfo(file);
+				FileInfo^ installed = gcnew FileInfo(Path::Combine(modelDirectory, source->Name));
+
+				if (!installed->Exists || installed->Length != source->Length || installed->LastWriteTimeUtc < source->LastWriteTimeUtc)
+					return false;
+			}
+
+			return true;
+		}
+	};
+
+}
@@ -0,0 +1,81 @@
+// Parallel.hpp
+// Small thread pool helpers for the native image/model pipelines
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+// NOTE: <thread> and <atomic> are not available under /clr, so this header
+// may only be included from source files compiled without CLR support.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace R3ALInterop
+{
+
+	// Returns the number of worker threads to use. Passing 0 uses every core.
+	inline unsigned int WorkerCount(unsigned int requested = 0)
+	{
+		if (requested)
+			return requested;
+
+		unsigned int cores = std::thread::hardware_concurrency();
+
+		return cores ? cores : 1;
+	}
+
+	// Calls fn(index, worker) for every index in [0, count) using up to
+	// `workers` threads. Indices are handed out one at a time, so callers
+	// should pass coarse work items (rows, chunks, frames) rather than pixels.
+	// Results must be written to per-index or per-worker storage, and fn must
+	// not throw.
+	template <typename Fn>
+	void ParallelFor(size_t count, unsigned int workers, Fn fn)
+	{
+		workers = static_cast<unsigned int>(std::min<size_t>(WorkerCount(workers), count));
+
+		if (workers <= 1)
+		{
+			for (size_t i = 0; i < count; i++)
+				fn(i, 0u);
+
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+
+		auto run = [&](unsigned int worker)
+		{
+			for (size_t i = next++; i < count; i = next++)
+				fn(i, worker);
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(workers - 1);
+
+		for (unsigned int w = 1; w < workers; w++)
+			threads.emplace_back(run, w);
+
+		run(0);
+
+		for (std::thread& t : threads)
+			t.join();
+	}
+
+}
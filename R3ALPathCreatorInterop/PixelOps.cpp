@@ -0,0 +1,323 @@
+// PixelOps.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <intrin.h>
+#include <immintrin.h>
+
+#include "PixelOps.hpp"
+#include "Parallel.hpp"
+
+using namespace R3ALInterop;
+
+namespace
+{
+
+	// Contributing source texels for every target texel along one axis.
+	struct FilterTaps
+	{
+		std::vector<unsigned int> First;
+		std::vector<unsigned int> Count;
+		std::vector<size_t> Offset;   // Into Weights
+		std::vector<float> Weights;
+	};
+
+	void ComputeTaps(unsigned int sourceSize, unsigned int targetSize, FilterTaps& taps)
+	{
+		double scale = static_cast<double>(sourceSize) / targetSize;
+		double radius = std::max(scale, 1.0);
+		int last = static_cast<int>(sourceSize) - 1;
+
+		std::vector<double> weights;
+
+		for (unsigned int i = 0; i < targetSize; i++)
+		{
+			double center = (i + 0.5) * scale - 0.5;
+			int lo = static_cast<int>(std::floor(center - radius)) + 1;
+			int hi = static_cast<int>(std::ceil(center + radius)) - 1;
+			int first = std::min(std::max(lo, 0), last);
+			int end = std::max(std::min(hi, last), first);
+
+			// Taps outside the image are clamped onto the edge texels
+			weights.assign(end - first + 1, 0.0);
+			double total = 0.0;
+
+			for (int j = lo; j <= hi; j++)
+			{
+				double w = 1.0 - std::fabs(j - center) / radius;
+
+				if (w <= 0.0)
+					continue;
+
+				weights[std::min(std::max(j, first), end) - first] += w;
+				total += w;
+			}
+
+			if (total <= 0.0)
+			{
+				weights[0] = 1.0;
+				total = 1.0;
+			}
+
+			taps.First.push_back(first);
+			taps.Count.push_back(static_cast<unsigned int>(weights.size()));
+			taps.Offset.push_back(taps.Weights.size());
+
+			for (double w : weights)
+				taps.Weights.push_back(static_cast<float>(w / total));
+		}
+	}
+
+	__m128 LoadPixel(const unsigned char* p)
+	{
+		int packed;
+		std::memcpy(&packed, p, 4);
+
+		__m128i zero = _mm_setzero_si128();
+		__m128i wide = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+
+		return _mm_cvtepi32_ps(wide);
+	}
+
+	void StorePixel(unsigned char* p, __m128 value)
+	{
+		value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+
+		__m128i wide = _mm_cvtps_epi32(value);
+		__m128i narrow = _mm_packus_epi16(_mm_packs_epi32(wide, wide), wide);
+		int packed = _mm_cvtsi128_si32(narrow);
+
+		std::memcpy(p, &packed, 4);
+	}
+
+	// Converts one source row to premultiplied float and filters it horizontally.
+	void FilterRow(const unsigned char* source, unsigned int sourceWidth, const FilterTaps& taps,
+		float* premultiplied, float* target)
+	{
+		const __m128 alphaLane = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+		const __m128 inv255 = _mm_set1_ps(1.0f / 255.0f);
+
+		for (unsigned int x = 0; x < sourceWidth; x++)
+		{
+			__m128 pixel = LoadPixel(source + x * 4);
+			__m128 alpha = _mm_mul_ps(_mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3)), inv255);
+
+			// (r * a, g * a, b * a, a)
+			__m128 scaled = _mm_mul_ps(pixel, alpha);
+			_mm_storeu_ps(premultiplied + x * 4, _mm_or_ps(_mm_andnot_ps(alphaLane, scaled), _mm_and_ps(alphaLane, pixel)));
+		}
+
+		for (size_t i = 0; i < taps.First.size(); i++)
+		{
+			const float* texel = premultiplied + static_cast<size_t>(taps.First[i]) * 4;
+			const float* weight = &taps.Weights[taps.Offset[i]];
+			__m128 sum = _mm_setzero_ps();
+
+			for (unsigned int k = 0; k < taps.Count[i]; k++, texel += 4)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(texel), _mm_set1_ps(weight[k])));
+
+			_mm_storeu_ps(target + i * 4, sum);
+		}
+	}
+
+	// sum[i] += row[i] * weight, count is a multiple of 4.
+	void AccumulateSse(float* sum, const float* row, float weight, size_t count)
+	{
+		__m128 w = _mm_set1_ps(weight);
+
+		for (size_t i = 0; i < count; i += 4)
+			_mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_mul_ps(_mm_loadu_ps(row + i), w)));
+	}
+
+	void AccumulateAvx(float* sum, const float* row, float weight, size_t count)
+	{
+		__m256 w = _mm256_set1_ps(weight);
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(sum + i, _mm256_add_ps(_mm256_loadu_ps(sum + i), _mm256_mul_ps(_mm256_loadu_ps(row + i), w)));
+
+		_mm256_zeroupper();
+
+		AccumulateSse(sum + i, row + i, weight, count - i);
+	}
+
+	// Converts a filtered premultiplied row back to straight alpha bytes.
+	void StoreRow(const float* sum, unsigned int width, unsigned char* target)
+	{
+		const __m128 alphaLane = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+		const __m128 full = _mm_set1_ps(255.0f);
+
+		for (unsigned int x = 0; x < width; x++)
+		{
+			__m128 pixel = _mm_loadu_ps(sum + x * 4);
+			__m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+			__m128 visible = _mm_cmpgt_ps(alpha, _mm_setzero_ps());
+			__m128 scale = _mm_and_ps(visible, _mm_div_ps(full, _mm_max_ps(alpha, _mm_set1_ps(1.0e-6f))));
+			__m128 straight = _mm_mul_ps(pixel, scale);
+
+			StorePixel(target + x * 4, _mm_or_ps(_mm_andnot_ps(alphaLane, straight), _mm_and_ps(alphaLane, pixel)));
+		}
+	}
+
+	// out = c0 * r + c1 * g + c2 * b + c3 + (0, 0, 0, a) for a row of pixels.
+	void TransformRow(const unsigned char* source, unsigned int width, const __m128* columns, unsigned char* target)
+	{
+		const __m128 alphaLane = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+		for (unsigned int x = 0; x < width; x++)
+		{
+			__m128 pixel = LoadPixel(source + x * 4);
+
+			__m128 value = _mm_add_ps(columns[3], _mm_and_ps(alphaLane, pixel));
+			value = _mm_add_ps(value, _mm_mul_ps(columns[0], _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(0, 0, 0, 0))));
+			value = _mm_add_ps(value, _mm_mul_ps(columns[1], _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(1, 1, 1, 1))));
+			value = _mm_add_ps(value, _mm_mul_ps(columns[2], _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(2, 2, 2, 2))));
+
+			StorePixel(target + x * 4, value);
+		}
+	}
+
+	bool DetectAvx()
+	{
+		int info[4];
+
+		__cpuid(info, 1);
+
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+
+		// The OS must save the YMM registers on context switches
+		return osxsave && avx && (_xgetbv(0) & 6) == 6;
+	}
+
+}
+
+#pragma region ColorTransform
+
+ColorTransform ColorTransform::Identity()
+{
+	return Multiply(1.0f, 1.0f, 1.0f);
+}
+
+ColorTransform ColorTransform::Multiply(float r, float g, float b)
+{
+	ColorTransform transform = { { r, 0, 0, 0, 0, g, 0, 0, 0, 0, b, 0 } };
+
+	return transform;
+}
+
+ColorTransform ColorTransform::Colorize(float r, float g, float b, float amount)
+{
+	// Rec. 601 luma weights
+	const float luma[3] = { 0.299f, 0.587f, 0.114f };
+	const float color[3] = { r, g, b };
+
+	ColorTransform transform = Identity();
+
+	for (int row = 0; row < 3; row++)
+	{
+		for (int column = 0; column < 3; column++)
+		{
+			float& m = transform.Matrix[row * 4 + column];
+			m = m * (1.0f - amount) + luma[column] * color[row] * amount;
+		}
+	}
+
+	return transform;
+}
+
+#pragma endregion
+
+#pragma region Resampling
+
+bool R3ALInterop::CpuHasAvx()
+{
+	static const bool avx = DetectAvx();
+
+	return avx;
+}
+
+void R3ALInterop::Resample(const RgbaImage& source, unsigned int width, unsigned int height, RgbaImage& destination)
+{
+	FilterTaps horizontal;
+	FilterTaps vertical;
+
+	ComputeTaps(source.Width, width, horizontal);
+	ComputeTaps(source.Height, height, vertical);
+
+	size_t rowFloats = static_cast<size_t>(width) * 4;
+	std::vector<float> filtered(rowFloats * source.Height);
+
+	unsigned int workers = WorkerCount();
+	std::vector<std::vector<float>> scratch(workers, std::vector<float>(std::max<size_t>(source.Width, width) * 4));
+
+	ParallelFor(source.Height, workers, [&](size_t y, unsigned int worker)
+	{
+		FilterRow(source.Row(static_cast<unsigned int>(y)), source.Width, horizontal, scratch[worker].data(), &filtered[y * rowFloats]);
+	});
+
+	destination.Resize(width, height);
+
+	bool avx = CpuHasAvx();
+
+	ParallelFor(height, workers, [&](size_t y, unsigned int worker)
+	{
+		float* sum = scratch[worker].data();
+		std::fill(sum, sum + rowFloats, 0.0f);
+
+		const float* weight = &vertical.Weights[vertical.Offset[y]];
+
+		for (unsigned int k = 0; k < vertical.Count[y]; k++)
+		{
+			const float* row = &filtered[(vertical.First[y] + k) * rowFloats];
+
+			if (avx)
+				AccumulateAvx(sum, row, weight[k], rowFloats);
+			else
+				AccumulateSse(sum, row, weight[k], rowFloats);
+		}
+
+		StoreRow(sum, width, destination.Row(static_cast<unsigned int>(y)));
+	});
+}
+
+#pragma endregion
+
+#pragma region Color
+
+void R3ALInterop::TransformColors(const RgbaImage& source, const ColorTransform& transform, RgbaImage& destination,
+	unsigned int threads)
+{
+	const float* m = transform.Matrix;
+
+	// Column j holds the contribution of input channel j to (r, g, b, a)
+	__m128 columns[4];
+
+	for (int j = 0; j < 4; j++)
+		columns[j] = _mm_setr_ps(m[j], m[4 + j], m[8 + j], 0.0f);
+
+	destination.Resize(source.Width, source.Height);
+
+	ParallelFor(source.Height, WorkerCount(threads), [&](size_t y, unsigned int)
+	{
+		unsigned int row = static_cast<unsigned int>(y);
+		TransformRow(source.Row(row), source.Width, columns, destination.Row(row));
+	});
+}
+
+#pragma endregion
@@ -0,0 +1,57 @@
+// PixelOps.hpp
+// Vectorized analysis and conversion kernels over RgbaImage buffers
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include "Imaging.hpp"
+
+namespace R3ALInterop
+{
+
+	// Affine color transform on 0-255 RGB values:
+	//     r' = m[0] * r + m[1] * g + m[2] * b + m[3]
+	//     g' = m[4] * r + ...
+	// Alpha is left as is.
+	struct ColorTransform
+	{
+		float Matrix[12];
+
+		static ColorTransform Identity();
+
+		// Scales each channel, 1 keeps it.
+		static ColorTransform Multiply(float r, float g, float b);
+
+		// Replaces the hue with the given color while keeping the shading:
+		// luminance times (r, g, b), blended with the original by `amount`.
+		static ColorTransform Colorize(float r, float g, float b, float amount);
+	};
+
+	// True if the CPU and OS support AVX, checked once.
+	bool CpuHasAvx();
+
+	// Resizes with a separable triangle filter (box-like when shrinking).
+	// Filtering is done on premultiplied alpha so transparent texels do not
+	// bleed their color into visible ones. Rows are split across worker
+	// threads, the vertical pass uses AVX when available.
+	void Resample(const RgbaImage& source, unsigned int width, unsigned int height, RgbaImage& destination);
+
+	// Applies `transform` to every pixel with SSE, 4 channels per step.
+	// `threads` is the number of workers, 0 = all cores.
+	void TransformColors(const RgbaImage& source, const ColorTransform& transform, RgbaImage& destination,
+		unsigned int threads = 0);
+
+}
@@ -0,0 +1,36 @@
+// SectionSchema.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include "SectionSchema.hpp"
+
+using namespace R3ALInterop;
+
+void R3ALInterop::SetPathSections(RCT3Asset::Path& ptd, const std::vector<std::string>& models, bool extended)
+{
+	size_t count = extended ? PathSectionCount - 1 : BasicSectionCount;
+
+	for (size_t i = 0; i < count; i++)
+		ptd.*PathSectionFields[i] = models[i];
+
+	if (extended)
+		ptd.Paving = models[static_cast<size_t>(PathSectionId::Paving)];
+}
+
+void R3ALInterop::SetQueueSections(RCT3Asset::Queue& qtd, const std::vector<std::string>& models)
+{
+	for (size_t i = 0; i < QueueSectionCount; i++)
+		qtd.*QueueSectionFields[i] = models[i];
+}
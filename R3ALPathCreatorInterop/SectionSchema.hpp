@@ -0,0 +1,212 @@
+// SectionSchema.hpp
+// Compile-time tables of the model sections of paths and queues
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <Path.hpp>
+#include <Queue.hpp>
+
+#pragma region Section lists
+
+// Every path section stored as an RCT3Asset::PathSection, in project file
+// order: X(MPath property, RCT3Asset::Path field). The field name is also
+// the model name suffix OvlModelSearcher matches.
+
+#define R3AL_BASIC_PATH_SECTIONS(X) \
+	X(Flat, Flat) \
+	X(StraightA, StraightA) \
+	X(StraightB, StraightB) \
+	X(CornerA, CornerA) \
+	X(CornerB, CornerB) \
+	X(CornerC, CornerC) \
+	X(CornerD, CornerD) \
+	X(TurnU, TurnU) \
+	X(TurnLA, TurnLA) \
+	X(TurnLB, TurnLB) \
+	X(TurnTA, TurnTA) \
+	X(TurnTB, TurnTB) \
+	X(TurnTC, TurnTC) \
+	X(TurnX, TurnX) \
+	X(Slope, Slope) \
+	X(SlopeStraight, SlopeStraight) \
+	X(SlopeStraightL, SlopeStraightLeft) \
+	X(SlopeStraightR, SlopeStraightRight) \
+	X(SlopeMid, SlopeMid)
+
+#define R3AL_EXTENDED_PATH_SECTIONS(X) \
+	X(FlatFC, FlatFC) \
+	X(SlopeFC, SlopeFC) \
+	X(SlopeBC, SlopeBC) \
+	X(SlopeTC, SlopeTC) \
+	X(SlopeStraightFC, SlopeStraightFC) \
+	X(SlopeStraightBC, SlopeStraightBC) \
+	X(SlopeStraightTC, SlopeStraightTC) \
+	X(SlopeStraightLFC, SlopeStraightLeftFC) \
+	X(SlopeStraightLBC, SlopeStraightLeftBC) \
+	X(SlopeStraightLTC, SlopeStraightLeftTC) \
+	X(SlopeStraightRFC, SlopeStraightRightFC) \
+	X(SlopeStraightRBC, SlopeStraightRightBC) \
+	X(SlopeStraightRTC, SlopeStraightRightTC) \
+	X(SlopeMidFC, SlopeMidFC) \
+	X(SlopeMidBC, SlopeMidBC) \
+	X(SlopeMidTC, SlopeMidTC)
+
+// Every queue section, in project file order: X(MQueue property and
+// RCT3Asset::Queue field, OvlModelSearcher suffix or nullptr, required).
+
+#define R3AL_QUEUE_SECTIONS(X) \
+	X(Straight, "Straight", true) \
+	X(TurnL, "TurnL", true) \
+	X(TurnR, "TurnR", true) \
+	X(SlopeUp, "SlopeUp", true) \
+	X(SlopeDown, "SlopeDown", true) \
+	X(SlopeStraight1, "SlopeStraight", true) \
+	X(SlopeStraight2, nullptr, false)
+
+#pragma endregion
+
+namespace R3ALInterop
+{
+
+	enum class SectionSet
+	{
+		Basic,     // Required by every path
+		Extended,  // Optional, only used by extended paths
+		Queue
+	};
+
+	struct SectionInfo
+	{
+		const char* Name;  // MPath/MQueue property
+		const char* Role;  // Model name suffix OvlModelSearcher matches, nullptr if not searched for
+		SectionSet Set;
+		bool Required;     // Must have a model, optional sections are skipped when empty
+	};
+
+	#pragma region Path sections
+
+	#define R3AL_SECTION_ID(PROPERTY, ...) PROPERTY,
+
+	// Index of each path section in PathSections.
+	enum class PathSectionId
+	{
+		R3AL_BASIC_PATH_SECTIONS(R3AL_SECTION_ID)
+		R3AL_EXTENDED_PATH_SECTIONS(R3AL_SECTION_ID)
+		Paving,  // A plain string in RCT3Asset::Path, so it has no entry in PathSectionFields
+		Count
+	};
+
+	#define R3AL_BASIC_SECTION_INFO(PROPERTY, FIELD) { #PROPERTY, #FIELD, SectionSet::Basic, true },
+	#define R3AL_EXTENDED_SECTION_INFO(PROPERTY, FIELD) { #PROPERTY, #FIELD, SectionSet::Extended, false },
+
+	constexpr SectionInfo PathSections[] =
+	{
+		R3AL_BASIC_PATH_SECTIONS(R3AL_BASIC_SECTION_INFO)
+		R3AL_EXTENDED_PATH_SECTIONS(R3AL_EXTENDED_SECTION_INFO)
+		{ "Paving", "Paving", SectionSet::Extended, false }
+	};
+
+	#define R3AL_SECTION_FIELD(PROPERTY, FIELD) &RCT3Asset::Path::FIELD,
+
+	constexpr RCT3Asset::PathSection RCT3Asset::Path::* PathSectionFields[] =
+	{
+		R3AL_BASIC_PATH_SECTIONS(R3AL_SECTION_FIELD)
+		R3AL_EXTENDED_PATH_SECTIONS(R3AL_SECTION_FIELD)
+	};
+
+	#undef R3AL_SECTION_FIELD
+	#undef R3AL_EXTENDED_SECTION_INFO
+	#undef R3AL_BASIC_SECTION_INFO
+
+	#pragma endregion
+
+	#pragma region Queue sections
+
+	// Index of each queue section in QueueSections.
+	enum class QueueSectionId
+	{
+		R3AL_QUEUE_SECTIONS(R3AL_SECTION_ID)
+		Count
+	};
+
+	#define R3AL_QUEUE_SECTION_INFO(PROPERTY, ROLE, REQUIRED) { #PROPERTY, ROLE, SectionSet::Queue, REQUIRED },
+
+	constexpr SectionInfo QueueSections[] =
+	{
+		R3AL_QUEUE_SECTIONS(R3AL_QUEUE_SECTION_INFO)
+	};
+
+	#define R3AL_SECTION_FIELD(PROPERTY, ...) &RCT3Asset::Queue::PROPERTY,
+
+	constexpr std::string RCT3Asset::Queue::* QueueSectionFields[] =
+	{
+		R3AL_QUEUE_SECTIONS(R3AL_SECTION_FIELD)
+	};
+
+	#undef R3AL_SECTION_FIELD
+	#undef R3AL_QUEUE_SECTION_INFO
+	#undef R3AL_SECTION_ID
+
+	#pragma endregion
+
+	#pragma region Compile-time checks
+
+	// Number of entries of `set` in the first `count` sections.
+	constexpr size_t CountSections(const SectionInfo* sections, size_t count, SectionSet set)
+	{
+		return count == 0 ? 0 : (sections[count - 1].Set == set ? 1 : 0) + CountSections(sections, count - 1, set);
+	}
+
+	// True if no section follows one of a later set.
+	constexpr bool SectionsOrdered(const SectionInfo* sections, size_t count)
+	{
+		return count < 2 || (sections[count - 2].Set <= sections[count - 1].Set && SectionsOrdered(sections, count - 1));
+	}
+
+	constexpr size_t PathSectionCount = sizeof(PathSections) / sizeof(PathSections[0]);
+	constexpr size_t BasicSectionCount = CountSections(PathSections, PathSectionCount, SectionSet::Basic);
+	constexpr size_t QueueSectionCount = sizeof(QueueSections) / sizeof(QueueSections[0]);
+
+	static_assert(PathSectionCount == static_cast<size_t>(PathSectionId::Count), "PathSections does not match PathSectionId");
+	static_assert(PathSectionCount == sizeof(PathSectionFields) / sizeof(PathSectionFields[0]) + 1, "Every path section but Paving needs a field");
+	static_assert(SectionsOrdered(PathSections, PathSectionCount), "Basic path sections must come before extended ones");
+	static_assert(QueueSectionCount == static_cast<size_t>(QueueSectionId::Count), "QueueSections does not match QueueSectionId");
+	static_assert(QueueSectionCount == sizeof(QueueSectionFields) / sizeof(QueueSectionFields[0]), "Every queue section needs a field");
+
+	#pragma endregion
+
+	// True if the section goes into the stub and its model is copied.
+	inline bool IsSectionUsed(const SectionInfo& section, bool hasModel, bool extended)
+	{
+		if (section.Set == SectionSet::Extended && !extended)
+			return false;
+
+		return section.Required || hasModel;
+	}
+
+	// Sets every section field of `ptd` from models[i], the model name of
+	// PathSections[i]. Extended sections are left empty unless `extended`.
+	void SetPathSections(RCT3Asset::Path& ptd, const std::vector<std::string>& models, bool extended);
+
+	// Same for the queue fields of `qtd` from QueueSections.
+	void SetQueueSections(RCT3Asset::Queue& qtd, const std::vector<std::string>& models);
+
+}
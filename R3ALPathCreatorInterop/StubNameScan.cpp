@@ -0,0 +1,283 @@
+// StubNameScan.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#include "StubNameScan.hpp"
+#include "Parallel.hpp"
+
+using namespace R3ALInterop;
+
+namespace
+{
+
+	// Read-only view of a whole file.
+	class MappedFile
+	{
+	private:
+		HANDLE _file;
+		HANDLE _mapping;
+		const unsigned char* _data;
+		size_t _size;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+	public:
+		MappedFile()
+			: _file(INVALID_HANDLE_VALUE), _mapping(nullptr), _data(nullptr), _size(0)
+		{
+		}
+
+		~MappedFile()
+		{
+			if (_data)
+				UnmapViewOfFile(_data);
+
+			if (_mapping)
+				CloseHandle(_mapping);
+
+			if (_file != INVALID_HANDLE_VALUE)
+				CloseHandle(_file);
+		}
+
+		bool Open(const std::string& fileName, std::string& error)
+		{
+			_file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+				FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+			LARGE_INTEGER size;
+
+			if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size))
+			{
+				error = "Failed to open \"" + fileName + "\".";
+				return false;
+			}
+
+			// Empty files cannot be mapped, there is nothing to read anyway
+			if (!size.QuadPart)
+				return true;
+
+			_size = static_cast<size_t>(size.QuadPart);
+			_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (_mapping)
+				_data = static_cast<const unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+
+			if (!_data)
+			{
+				error = "Failed to map \"" + fileName + "\".";
+				return false;
+			}
+
+			return true;
+		}
+
+		const unsigned char* Data() const { return _data; }
+		size_t Size() const { return _size; }
+	};
+
+	bool IsNameChar(unsigned char c)
+	{
+		return c >= 0x20 && c < 0x7F;
+	}
+
+	bool IsTextChar(unsigned int c)
+	{
+		return (c >= 0x20 && c < 0x7F) || (c >= 0xA0 && c < 0x250);
+	}
+
+	void AddUnique(std::vector<std::string>& names, const std::string& name)
+	{
+		if (std::find(names.begin(), names.end(), name) == names.end())
+			names.push_back(name);
+	}
+
+	// Sorts one NUL terminated string into the summary. Symbols are stored as
+	// "<name>:<type>", sid OVL paths as "Path\<project>\<model>" or
+	// "Queue\<project>\<model>".
+	void AddString(const std::string& value, StubSummary& stub, std::vector<std::string>& ovlPaths)
+	{
+		size_t colon = value.rfind(':');
+
+		if (colon != std::string::npos && colon > 0 && value.size() - colon == 4)
+		{
+			std::string name = value.substr(0, colon);
+			std::string type = value.substr(colon + 1);
+
+			if (type == "ptd" || type == "qtd")
+			{
+				stub.Kind = type == "ptd" ? StubKind::Path : StubKind::Queue;
+				stub.Name = name;
+			}
+			else if (type == "sid")
+				AddUnique(stub.Sections, name);
+			else if (type == "tex" || type == "ftx")
+				AddUnique(stub.Textures, name);
+
+			return;
+		}
+
+		if (value.compare(0, 5, "Path\\") == 0 || value.compare(0, 6, "Queue\\") == 0)
+			ovlPaths.push_back(value);
+	}
+
+	void ScanNames(const unsigned char* data, size_t size, StubSummary& stub, std::vector<std::string>& ovlPaths)
+	{
+		size_t start = 0;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			if (IsNameChar(data[i]))
+				continue;
+
+			if (data[i] == 0 && i - start >= 3)
+				AddString(std::string(reinterpret_cast<const char*>(data + start), i - start), stub, ovlPaths);
+
+			start = i + 1;
+		}
+	}
+
+	// Finds the first UTF-16 string, trying both alignments.
+	void ScanText(const unsigned char* data, size_t size, StubSummary& stub)
+	{
+		for (size_t alignment = 0; alignment < 2 && stub.Text.empty(); alignment++)
+		{
+			size_t start = alignment;
+
+			for (size_t i = alignment; i + 1 < size; i += 2)
+			{
+				unsigned int c = data[i] | (data[i + 1] << 8);
+
+				if (IsTextChar(c))
+					continue;
+
+				// Two characters at least, and not an ASCII name that happens to
+				// be followed by a zero byte
+				if (c == 0 && i - start >= 4)
+				{
+					stub.Text.reserve((i - start) / 2);
+
+					for (size_t j = start; j < i; j += 2)
+						stub.Text.push_back(static_cast<wchar_t>(data[j] | (data[j + 1] << 8)));
+
+					return;
+				}
+
+				start = i + 2;
+			}
+		}
+	}
+
+	bool ScanFile(const std::string& fileName, StubSummary& stub, std::vector<std::string>& ovlPaths, std::string& error)
+	{
+		MappedFile file;
+
+		if (!file.Open(fileName, error))
+			return false;
+
+		ScanNames(file.Data(), file.Size(), stub, ovlPaths);
+
+		if (stub.Text.empty())
+			ScanText(file.Data(), file.Size(), stub);
+
+		return true;
+	}
+
+}
+
+bool R3ALInterop::ScanStubOvl(const std::string& commonFile, StubSummary& stub, std::string& error)
+{
+	stub = StubSummary();
+
+	std::vector<std::string> ovlPaths;
+
+	if (!ScanFile(commonFile, stub, ovlPaths, error))
+		return false;
+
+	const std::string common = "common.ovl";
+
+	if (commonFile.size() > common.size() && commonFile.compare(commonFile.size() - common.size(), common.size(), common) == 0)
+	{
+		std::string uniqueFile = commonFile.substr(0, commonFile.size() - common.size()) + "unique.ovl";
+
+		if (GetFileAttributesA(uniqueFile.c_str()) != INVALID_FILE_ATTRIBUTES && !ScanFile(uniqueFile, stub, ovlPaths, error))
+			return false;
+	}
+
+	// Files without symbol names still name their models in the sid OVL paths
+	for (const std::string& ovlPath : ovlPaths)
+	{
+		size_t first = ovlPath.find('\\');
+		size_t last = ovlPath.rfind('\\');
+
+		if (last == first || last + 1 == ovlPath.size())
+			continue;
+
+		if (stub.Kind == StubKind::Unknown)
+		{
+			stub.Kind = ovlPath[0] == 'P' ? StubKind::Path : StubKind::Queue;
+			stub.Name = ovlPath.substr(first + 1, last - first - 1);
+		}
+
+		AddUnique(stub.Sections, ovlPath.substr(last + 1));
+	}
+
+	if (stub.Kind == StubKind::Unknown)
+	{
+		stub.Textures.clear();
+		stub.Sections.clear();
+		stub.Text.clear();
+	}
+	else if (stub.Kind == StubKind::Path)
+	{
+		// ptd flags and extended values
+		stub.Unrecovered = { "UnderwaterSupport", "Unknown01", "Unknown02" };
+	}
+	else
+	{
+		// ftx recolorability
+		stub.Unrecovered = { "Recolor1", "Recolor2", "Recolor3" };
+	}
+
+	return true;
+}
+
+void R3ALInterop::ScanStubOvls(const std::vector<std::string>& files, std::vector<StubSummary>& stubs, std::vector<std::string>& errors)
+{
+	stubs.assign(files.size(), StubSummary());
+	errors.assign(files.size(), std::string());
+
+	// Scanning is bound by reading the files, which overlaps well
+	ParallelFor(files.size(), WorkerCount(), [&](size_t i, unsigned int)
+	{
+		ScanStubOvl(files[i], stubs[i], errors[i]);
+	});
+}
+
+std::string R3ALInterop::ModelRole(const std::string& modelName)
+{
+	size_t underscore = modelName.rfind('_');
+
+	if (underscore == std::string::npos)
+		return "";
+
+	return modelName.substr(underscore + 1);
+}
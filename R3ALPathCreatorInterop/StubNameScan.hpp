@@ -0,0 +1,67 @@
+// StubNameScan.hpp
+// Best-effort name scan of path and queue stub OVLs, for drafting projects
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace R3ALInterop
+{
+
+	enum class StubKind
+	{
+		Unknown,  // Not a path or queue stub
+		Path,
+		Queue
+	};
+
+	// What a stub OVL says about the project it was built from.
+	struct StubSummary
+	{
+		StubKind Kind;
+		std::string Name;                   // ptd/qtd name
+		std::wstring Text;                  // In-game name, empty if none was found
+		std::vector<std::string> Textures;  // tex (path) or ftx (queue) names, in file order
+		std::vector<std::string> Sections;  // sid names, which are the model OVL names, in file order
+		std::vector<std::string> Unrecovered;  // Project fields the scan cannot read, they keep their defaults
+
+		StubSummary()
+			: Kind(StubKind::Unknown)
+		{
+		}
+	};
+
+	// Maps a stub OVL (and its unique OVL, if present) into memory and picks
+	// printable symbol names and strings out of the raw bytes. This is a
+	// best-effort scan, not a parser: the ptd, qtd, sid, txt and gsi records
+	// are never decoded, so flags and numbers are lost and listed in
+	// StubSummary::Unrecovered. The in-game name is the first UTF-16 string
+	// found and may be wrong.
+	//     * Returns false if a file cannot be read, a file that is not a
+	//       stub returns true with StubKind::Unknown
+	bool ScanStubOvl(const std::string& commonFile, StubSummary& stub, std::string& error);
+
+	// ScanStubOvl over many files using every core. errors[i] is empty when
+	// files[i] was read.
+	void ScanStubOvls(const std::vector<std::string>& files, std::vector<StubSummary>& stubs, std::vector<std::string>& errors);
+
+	// Returns the section a model OVL is for, following OvlModelSearcher's
+	// naming scheme: "<anything>_<Role>". Returns "" if there is no '_'.
+	std::string ModelRole(const std::string& modelName);
+
+}
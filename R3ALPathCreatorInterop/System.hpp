@@ -35,28 +35,42 @@ using namespace System::Runtime::CompilerServices;
 namespace R3ALInterop
 {
 
+	// Width & height of the GUI icons created by CreateIconOVL.
+	const unsigned int IconSize = 40;
+
 	public ref class RCT3AssetLibrary
 	{
+	private:
+		static double _startupMilliseconds = -1.0;  // -1 until Initialize has run
+
 	public:
 
+		// Starts the asset library, which also starts GraphicsMagick, and
+		// times it for GetStartupReport.
 		static void Initialize(array<wchar_t>^ args)
 		{
-			if (args == nullptr)
-			{
-				RCT3Asset::InitializeRCT3AssetLibrary(nullptr);
-				return;
-			}
+			Diagnostics::Stopwatch^ timer = Diagnostics::Stopwatch::StartNew();
 
-			if (args->Length)
+			if (args == nullptr || !args->Length)
 			{
-				IntPtr p = Marshal::StringToHGlobalAnsi(gcnew String(args));
-				RCT3Asset::InitializeRCT3AssetLibrary(static_cast<const char*>(p.ToPointer()));
-				Marshal::FreeHGlobal(p);
+				RCT3Asset::InitializeRCT3AssetLibrary(nullptr);
 			}
 			else
 			{
-				RCT3Asset::InitializeRCT3AssetLibrary(nullptr);
+				std::string arguments = marshal_as<std::string>(gcnew String(args));
+				RCT3Asset::InitializeRCT3AssetLibrary(arguments.c_str());
 			}
+
+			_startupMilliseconds = timer->Elapsed.TotalMilliseconds;
+		}
+
+		// Returns how long Initialize took.
+		static String^ GetStartupReport()
+		{
+			if (_startupMilliseconds < 0.0)
+				return "Startup timing: not initialized";
+
+			return String::Format("Startup timing: RCT3AssetLibrary {0:F1} ms", _startupMilliseconds);
 		}
 
 	};
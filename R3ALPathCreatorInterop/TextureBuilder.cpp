@@ -0,0 +1,166 @@
+// TextureBuilder.cpp
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#include <OutputLog.hpp>
+
+#include "TextureBuilder.hpp"
+#include "Metrics.hpp"
+#include "Parallel.hpp"
+
+using namespace R3ALInterop;
+
+#pragma region TextureBuilder
+
+TextureBuilder::TextureBuilder(RCT3Debugging::OutputLog& log)
+	: _log(log)
+{
+}
+
+bool TextureBuilder::Build(const std::string& fileName, const std::string& name, const RCT3Asset::TextureStyle& style,
+	RCT3Asset::Texture& texture, const TextureOptions& options)
+{
+	unsigned int sourceWidth;
+	unsigned int sourceHeight;
+
+	{
+		std::string error;
+
+		if (!ProbeImage(fileName, sourceWidth, sourceHeight, error))
+		{
+			_log.Error(error);
+			return false;
+		}
+	}
+
+	// Sources already at size are never decoded here
+	if ((!options.Width || options.Width == sourceWidth) && (!options.Height || options.Height == sourceHeight))
+	{
+		Finish(fileName, name, style, sourceWidth, sourceHeight, texture, options);
+		return true;
+	}
+
+	RgbaImage pixels;
+
+	if (!Decode(fileName, name, options, pixels))
+		return false;
+
+	if (IsCancelled(options.Control))
+		return false;
+
+	// TexImage only reads files, so resized pixels go through a temporary TGA
+	TemporaryFile staged(".tga");
+
+	if (!EncodeImage(staged.FileName(), pixels, _log))
+		return false;
+
+	Finish(staged.FileName(), name, style, pixels.Width, pixels.Height, texture, options);
+	return true;
+}
+
+bool TextureBuilder::Decode(const std::string& fileName, const std::string& name, const TextureOptions& options, RgbaImage& pixels)
+{
+	if (!DecodeImage(fileName, pixels, _log))
+		return false;
+
+	unsigned int width = options.Width ? options.Width : pixels.Width;
+	unsigned int height = options.Height ? options.Height : pixels.Height;
+
+	if (width != pixels.Width || height != pixels.Height)
+	{
+		_log.Info(name + ": resampling " + std::to_string(pixels.Width) + "x" + std::to_string(pixels.Height) +
+			" to " + std::to_string(width) + "x" + std::to_string(height));
+
+		StageTimer timer(MetricsFor(_log), Stage::Resample);
+
+		RgbaImage resized;
+		Resample(pixels, width, height, resized);
+		pixels = std::move(resized);
+	}
+
+	return true;
+}
+
+bool TextureBuilder::BuildVariants(const RgbaImage& pixels, const std::vector<ColorTransform>& transforms,
+	const std::vector<std::string>& names, const RCT3Asset::TextureStyle& style,
+	std::vector<RCT3Asset::Texture>& textures, const TextureOptions& options)
+{
+	// Recoloring and writing the staged TGAs runs on every core, the
+	// TexImages log as they load, so they are created on this thread.
+	std::vector<std::unique_ptr<TemporaryFile>> staged(transforms.size());
+	std::vector<std::string> errors(transforms.size());
+
+	for (size_t i = 0; i < transforms.size(); i++)
+		staged[i].reset(new TemporaryFile(".tga"));
+
+	ParallelFor(transforms.size(), 0, [&](size_t i, unsigned int)
+	{
+		if (IsCancelled(options.Control))
+			return;
+
+		RgbaImage recolored;
+		TransformColors(pixels, transforms[i], recolored, 1);
+
+		EncodeImage(staged[i]->FileName(), recolored, errors[i]);
+	});
+
+	if (IsCancelled(options.Control))
+		return false;
+
+	for (size_t i = 0; i < errors.size(); i++)
+	{
+		if (!errors[i].empty())
+		{
+			_log.Error(names[i] + ": " + errors[i]);
+			return false;
+		}
+	}
+
+	textures.resize(transforms.size());
+
+	for (size_t i = 0; i < transforms.size(); i++)
+		Finish(staged[i]->FileName(), names[i], style, pixels.Width, pixels.Height, textures[i], options);
+
+	return true;
+}
+
+void TextureBuilder::Finish(const std::string& fileName, const std::string& name, const RCT3Asset::TextureStyle& style,
+	unsigned int width, unsigned int height, RCT3Asset::Texture& texture,
+	const TextureOptions& options)
+{
+	long long blocks = static_cast<long long>((width + 3) / 4) * ((height + 3) / 4);
+
+	AddProgress(options.Control, &BuildControl::BlocksTotal, blocks);
+
+	std::shared_ptr<BuildMetrics> metrics = MetricsFor(_log);
+
+	{
+		StageTimer timer(metrics, Stage::TextureLoad);
+
+		_images.emplace_back(new RCT3Asset::TexImage(_log));
+		_images.back()->FromFile(fileName);
+	}
+
+	AddProgress(options.Control, &BuildControl::BlocksLoaded, blocks);
+	metrics->Add(Counter::BlocksLoaded, static_cast<unsigned long long>(blocks));
+
+	RCT3Asset::TextureMip mainMip(*_images.back());
+
+	texture.Name(name);
+	texture.TxsStyle = style;
+	texture.Mips.push_back(mainMip);
+}
+
+#pragma endregion
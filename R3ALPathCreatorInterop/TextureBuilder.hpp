@@ -0,0 +1,95 @@
+// TextureBuilder.hpp
+// Builds RCT3Asset::Texture objects from source images
+
+/*
+* (C) Copyright 2015 Noah Roth
+*
+* All rights reserved. This program and the accompanying materials
+* are made available under the terms of the GNU Lesser General Public License
+* (LGPL) version 2.1 which accompanies this distribution, and is available at
+* http://www.gnu.org/licenses/lgpl-2.1.html
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* Lesser General Public License for more details.
+*/
+
+#pragma once
+
+#include <memory>
+
+#include <Texture.hpp>
+
+#include "Imaging.hpp"
+#include "PixelOps.hpp"
+#include "BuildControl.hpp"
+
+namespace R3ALInterop
+{
+
+	// Target size of a built texture.
+	struct TextureOptions
+	{
+		unsigned int Width;   // 0 = source width
+		unsigned int Height;  // 0 = source height
+		BuildControl* Control; // Optional progress and cancellation
+
+		TextureOptions()
+			: Width(0), Height(0), Control(nullptr)
+		{
+		}
+
+		TextureOptions(unsigned int width, unsigned int height)
+			: Width(width), Height(height), Control(nullptr)
+		{
+		}
+	};
+
+	// Builds textures from image files. Owns the TexImages the mips are made
+	// from, so it has to outlive the OvlFile::Save call.
+	class TextureBuilder
+	{
+	private:
+		RCT3Debugging::OutputLog& _log;
+		std::vector<std::unique_ptr<RCT3Asset::TexImage>> _images;
+
+		TextureBuilder(const TextureBuilder&) = delete;
+		TextureBuilder& operator=(const TextureBuilder&) = delete;
+
+		// Loads `fileName` into a TexImage and points `texture` at it.
+		void Finish(const std::string& fileName, const std::string& name, const RCT3Asset::TextureStyle& style,
+			unsigned int width, unsigned int height, RCT3Asset::Texture& texture,
+			const TextureOptions& options);
+
+	public:
+
+		// Constructor.
+		TextureBuilder(RCT3Debugging::OutputLog& log);
+
+		// Loads `fileName` into `texture` as a single mip. Images already at the
+		// requested size are loaded straight from `fileName`. Others are decoded,
+		// resampled and written to a temporary TGA first, as TexImage only
+		// reads files.
+		//     * Registers errors to the OutputLog, returns false on failure
+		//     * Returns false without an error if options.Control was cancelled
+		bool Build(const std::string& fileName, const std::string& name, const RCT3Asset::TextureStyle& style,
+			RCT3Asset::Texture& texture, const TextureOptions& options = TextureOptions());
+
+		// Decodes `fileName` and resamples it to the size Build would use,
+		// for building several textures from one source.
+		//     * Registers errors to the OutputLog, returns false on failure
+		bool Decode(const std::string& fileName, const std::string& name, const TextureOptions& options, RgbaImage& pixels);
+
+		// Builds textures[i], named names[i], from `pixels` recolored by
+		// transforms[i]. The variants are recolored and written out on every
+		// core, then loaded into TexImages one after the other.
+		//     * Registers errors to the OutputLog, returns false on failure
+		//     * Returns false without an error if options.Control was cancelled
+		bool BuildVariants(const RgbaImage& pixels, const std::vector<ColorTransform>& transforms,
+			const std::vector<std::string>& names, const RCT3Asset::TextureStyle& style,
+			std::vector<RCT3Asset::Texture>& textures, const TextureOptions& options = TextureOptions());
+
+	};
+
+}
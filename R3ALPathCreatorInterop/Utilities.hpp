@@ -17,6 +17,7 @@
 #pragma once
 
 #include "System.hpp"
+#include "Metrics.hpp"
 
 class util
 {
@@ -30,7 +31,8 @@ public:
 		return file[file->Length - 1]->Split('.')[0];
 	}
 
-	static void CopyOvlFile(String^ ovlFileName, String^ destinationDirectory)
+	// Throws if the common or unique OVL of a model or the destination is missing.
+	static void CheckOvlFile(String^ ovlFileName, String^ destinationDirectory)
 	{
 		String^ common = ovlFileName;
 		String^ unique = common->Replace("common.ovl", "unique.ovl");
@@ -49,17 +51,147 @@ public:
 
 		if (!Directory::Exists(destinationDirectory))
 			throw gcnew System::IO::DirectoryNotFoundException(destinationDirectory);
+	}
+
+	static void CopyOvlFile(String^ ovlFileName, String^ destinationDirectory)
+	{
+		CheckOvlFile(ovlFileName, destinationDirectory);
+
+		String^ common = ovlFileName;
+		String^ unique = common->Replace("common.ovl", "unique.ovl");
 
 		File::Copy(common, destinationDirectory + Path::GetFileName(common));
 		File::Copy(unique, destinationDirectory + Path::GetFileName(unique));
 	}
 
-	__forceinline static void CopyOvlFileOptional(String^ ovlFileName, String^ destinationDirectory)
+	// Copies every model, after checking all of them, so a missing file
+	// throws before anything was copied.
+	static void CopyOvlFiles(List<String^>^ ovlFileNames, String^ destinationDirectory)
 	{
-		if (!String::IsNullOrWhiteSpace(ovlFileName))
+		for each (String^ ovlFileName in ovlFileNames)
+			CheckOvlFile(ovlFileName, destinationDirectory);
+
+		for each (String^ ovlFileName in ovlFileNames)
 			CopyOvlFile(ovlFileName, destinationDirectory);
 	}
 
+	// Adds the common and unique OVL of a model to `files`, if set.
+	static void AddOvlFiles(List<String^>^ files, String^ ovlFileName)
+	{
+		if (String::IsNullOrWhiteSpace(ovlFileName))
+			return;
+
+		files->Add(ovlFileName);
+		files->Add(ovlFileName->Replace("common.ovl", "unique.ovl"));
+	}
+
+	// Returns whichever of the plain, common and unique files saving an OVL
+	// to `path` produced.
+	static List<String^>^ GetSavedOvlFiles(String^ path)
+	{
+		List<String^>^ saved = gcnew List<String^>();
+		array<String^>^ files = { path, path + ".common.ovl", path + ".unique.ovl" };
+
+		for each (String^ file in files)
+		{
+			if (File::Exists(file))
+				saved->Add(file);
+		}
+
+		return saved;
+	}
+
+	// Saves an OVL, recording the time taken and the bytes written.
+	static void SaveOvl(RCT3Asset::OvlFile& ovl, String^ path, RCT3Debugging::OutputLog& log)
+	{
+		std::shared_ptr<BuildMetrics> metrics = MetricsFor(log);
+
+		{
+			StageTimer timer(metrics, Stage::OvlSave);
+			ovl.Save(std_string(path));
+		}
+
+		for each (String^ file in GetSavedOvlFiles(path))
+			metrics->Add(Counter::OvlBytesWritten, (gcnew FileInfo(file))->Length);
+	}
+
+	// Records copies of the common and unique OVLs of each model.
+	static void RecordOvlCopies(List<String^>^ ovlFileNames, RCT3Debugging::OutputLog& log)
+	{
+		std::shared_ptr<BuildMetrics> metrics = MetricsFor(log);
+
+		for each (String^ ovlFileName in ovlFileNames)
+		{
+			array<String^>^ files = { ovlFileName, ovlFileName->Replace("common.ovl", "unique.ovl") };
+
+			for each (String^ file in files)
+			{
+				metrics->Add(Counter::FilesCopied, 1);
+				metrics->Add(Counter::BytesCopied, (gcnew FileInfo(file))->Length);
+			}
+		}
+	}
+
+	// Returns true if both files have the same length and bytes.
+	static bool SameFileContents(String^ a, String^ b)
+	{
+		FileInfo^ infoA = gcnew FileInfo(a);
+		FileInfo^ infoB = gcnew FileInfo(b);
+
+		if (infoA->Length != infoB->Length)
+			return false;
+
+		FileStream^ streamA = infoA->OpenRead();
+		FileStream^ streamB = infoB->OpenRead();
+
+		try
+		{
+			array<unsigned char>^ bufferA = gcnew array<unsigned char>(64 * 1024);
+			array<unsigned char>^ bufferB = gcnew array<unsigned char>(64 * 1024);
+
+			int read;
+
+			while ((read = streamA->Read(bufferA, 0, bufferA->Length)) > 0)
+			{
+				// FileStream reads of local files fill the buffer, but do not rely on it
+				for (int filled = 0; filled < read;)
+				{
+					int more = streamB->Read(bufferB, filled, read - filled);
+
+					if (more <= 0)
+						return false;
+
+					filled += more;
+				}
+
+				for (int i = 0; i < read; i++)
+				{
+					if (bufferA[i] != bufferB[i])
+						return false;
+				}
+			}
+
+			return true;
+		}
+		finally
+		{
+			delete streamA;
+			delete streamB;
+		}
+	}
+
+	// Returns the OVL path a stub refers to a model by: the project's own
+	// directory unless `paths` redirects the model elsewhere.
+	static std::string ModelOvlPath(Dictionary<String^, String^>^ paths, const std::string& directory, const std::string& model)
+	{
+		String^ path;
+
+		if (paths->TryGetValue(marshal_as<String^>(model), path))
+			return std_string(path);
+
+		return directory + model;
+	}
+
 	__forceinline static std::string GetOvlName_std(String^ fileName)
 	{
 		return marshal_as<std::string>(GetOvlName(fileName));